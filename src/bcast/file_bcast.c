@@ -178,7 +178,13 @@ static int _get_job_info(struct bcast_parameters *params)
 	return rc;
 }
 
-/* Issue the RPC to transfer the file's data */
+/*
+ * Issue the RPC to transfer the file's data.
+ * The block is relayed down the generic message forwarding tree, where each
+ * slurmd receives the complete message before forwarding it and collects its
+ * subtree's replies before answering, so the next block is only sent once
+ * every node has this one.
+ */
 static int _file_bcast(struct bcast_parameters *params,
 		       file_bcast_msg_t *bcast_msg,
 		       job_sbcast_cred_msg_t *sbcast_cred)
@@ -218,22 +224,52 @@ static int _file_bcast(struct bcast_parameters *params,
 	return rc;
 }
 
-/* load a buffer with data from the file to broadcast,
- * return number of bytes read, zero on end of file */
-static int _get_block_none(char **buffer, int *orig_len, bool *more)
+/*
+ * Blocks are read (and compressed) by a separate thread so that preparing
+ * the next block overlaps with broadcasting the current one. Two slots are
+ * used in turn: the reader fills one while the other is being sent.
+ */
+#define BCAST_BLOCK_SLOTS 2
+
+typedef struct {
+	char *buffer;		/* compression output buffer, owned by slot */
+	char *data;		/* data to send, buffer or directly into src */
+	int32_t data_len;	/* length of data to send */
+	int32_t orig_len;	/* uncompressed length of data */
+	uint16_t compress;	/* compression used for data */
+	bool more;		/* false if this is the last block */
+	uint32_t time_compression; /* usec spent preparing the block */
+} bcast_block_t;
+
+static bcast_block_t block_slot[BCAST_BLOCK_SLOTS];
+static int block_slot_cnt = 0;		/* slots filled but not yet sent */
+static bool block_abort = false;	/* stop reading, broadcast failed */
+static pthread_mutex_t block_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t block_cond = PTHREAD_COND_INITIALIZER;
+
+/* position in the mmap'd source file, shared by all _get_block_*() */
+static int64_t remaining = -1;
+static void *position;
+
+static void _init_position(void)
 {
-	static int64_t remaining = -1;
-	static void *position;
-	int size;
-
 	if (remaining < 0) {
-		*buffer = xmalloc(block_len);
 		remaining = f_stat.st_size;
 		position = src;
 	}
+}
+
+/* point data at the next block of the file to broadcast, the block is sent
+ * straight out of the mmap'd file so no copy is needed,
+ * return number of bytes read, zero on end of file */
+static int _get_block_none(char **data, int *orig_len, bool *more)
+{
+	int size;
+
+	_init_position();
 
 	size = MIN(block_len, remaining);
-	memcpy(*buffer, position, size);
+	*data = position;
 	remaining -= size;
 	position += size;
 
@@ -242,20 +278,14 @@ static int _get_block_none(char **buffer, int *orig_len, bool *more)
 	return size;
 }
 
-static int _get_block_zlib(struct bcast_parameters *params,
-			   char **buffer,
-			   int *orig_len,
-			   bool *more)
+/* RET size of compressed block or -1 if compression is not available */
+static int _get_block_zlib(char **buffer, int *orig_len, bool *more)
 {
 #if HAVE_LIBZ
-	static z_stream strm;
+	z_stream strm;
 	int chunk = (256 * 1024);
 	int flush = Z_NO_FLUSH;
-
-	static int64_t remaining = -1;
-	static int max_out;
-	static void *position;
-	int chunk_remaining, out_remaining, chunk_bite, size = 0;
+	int max_out, chunk_remaining, out_remaining, chunk_bite, size = 0;
 
 	/* allocate deflate state, compress each block independently */
 	strm.zalloc = Z_NULL;
@@ -266,17 +296,13 @@ static int _get_block_zlib(struct bcast_parameters *params,
 	if (deflateInit(&strm, Z_DEFAULT_COMPRESSION) != Z_OK) {
 		error("File compression configuration error,"
 		      "sending uncompressed file.");
-		params->compress = 0;
-		return _get_block_none(buffer, orig_len, more);
+		return -1;
 	}
 
-	/* first pass through, initialize */
-	if (remaining < 0) {
-		remaining = f_stat.st_size;
-		max_out = deflateBound(&strm, block_len);
+	_init_position();
+	max_out = deflateBound(&strm, block_len);
+	if (!*buffer)
 		*buffer = xmalloc(max_out);
-		position = src;
-	}
 
 	chunk_remaining = MIN(block_len, remaining);
 	out_remaining = max_out;
@@ -307,20 +333,15 @@ static int _get_block_zlib(struct bcast_parameters *params,
 	return (max_out - out_remaining);
 #else
 	info("zlib compression not supported, sending uncompressed file.");
-	params->compress = 0;
-	return _get_block_none(buffer, orig_len, more);
+	return -1;
 #endif
 }
 
-static int _get_block_lz4(struct bcast_parameters *params,
-			  char **buffer,
-			  int32_t *orig_len,
-			  bool *more)
+/* RET size of compressed block or -1 if compression is not available */
+static int _get_block_lz4(char **buffer, int32_t *orig_len, bool *more)
 {
 #if HAVE_LZ4
 	int size_out;
-	static int64_t remaining = -1;
-	static void *position;
 	int size;
 
 	if (!f_stat.st_size) {
@@ -328,11 +349,9 @@ static int _get_block_lz4(struct bcast_parameters *params,
 		return 0;
 	}
 
-	if (remaining < 0) {
-		position = src;
-		remaining = f_stat.st_size;
+	_init_position();
+	if (!*buffer)
 		*buffer = xmalloc(block_len);
-	}
 
 	/* intentionally limit decompressed size to 10x compressed
 	 * to avoid problems on receive size when decompressed */
@@ -350,31 +369,79 @@ static int _get_block_lz4(struct bcast_parameters *params,
 	return size_out;
 #else
 	info("lz4 compression not supported, sending uncompressed file.");
-	params->compress = 0;
-	return _get_block_none(buffer, orig_len, more);
+	return -1;
 #endif
 
 }
 
-static int _next_block(struct bcast_parameters *params,
-		       char **buffer,
-		       int32_t *orig_len,
-		       bool *more)
+static void _next_block(struct bcast_parameters *params, bcast_block_t *block)
 {
+	int size = -1;
+
 	switch (params->compress) {
 	case COMPRESS_OFF:
-		return _get_block_none(buffer, orig_len, more);
+		break;
 	case COMPRESS_ZLIB:
-		return _get_block_zlib(params, buffer, orig_len, more);
+		size = _get_block_zlib(&block->buffer, &block->orig_len,
+				       &block->more);
+		break;
 	case COMPRESS_LZ4:
-		return _get_block_lz4(params, buffer, orig_len, more);
+		size = _get_block_lz4(&block->buffer, &block->orig_len,
+				      &block->more);
+		break;
+	default:
+		/* compression type not recognized */
+		error("File compression type %u not supported,"
+		      " sending uncompressed file.", params->compress);
+		break;
 	}
 
-	/* compression type not recognized */
-	error("File compression type %u not supported,"
-	      " sending uncompressed file.", params->compress);
-	params->compress = 0;
-	return _get_block_none(buffer, orig_len, more);
+	if (size >= 0) {
+		block->data = block->buffer;
+		block->data_len = size;
+	} else {
+		params->compress = COMPRESS_OFF;
+		block->data_len = _get_block_none(&block->data,
+						  &block->orig_len,
+						  &block->more);
+	}
+	block->compress = params->compress;
+}
+
+/* read and compress blocks ahead of the broadcast */
+static void *_block_reader(void *arg)
+{
+	struct bcast_parameters *params = arg;
+	bcast_block_t *block;
+	int inx = 0;
+	bool more = true;
+	DEF_TIMERS;
+
+	while (more) {
+		slurm_mutex_lock(&block_mutex);
+		while ((block_slot_cnt == BCAST_BLOCK_SLOTS) && !block_abort)
+			slurm_cond_wait(&block_cond, &block_mutex);
+		if (block_abort) {
+			slurm_mutex_unlock(&block_mutex);
+			break;
+		}
+		slurm_mutex_unlock(&block_mutex);
+
+		block = &block_slot[inx];
+		START_TIMER;
+		_next_block(params, block);
+		END_TIMER;
+		block->time_compression = DELTA_TIMER;
+		more = block->more;
+		inx = (inx + 1) % BCAST_BLOCK_SLOTS;
+
+		slurm_mutex_lock(&block_mutex);
+		block_slot_cnt++;
+		slurm_cond_broadcast(&block_cond);
+		slurm_mutex_unlock(&block_mutex);
+	}
+
+	return NULL;
 }
 
 /* read and broadcast the file */
@@ -382,12 +449,11 @@ static int _bcast_file(struct bcast_parameters *params)
 {
 	int rc = SLURM_SUCCESS;
 	file_bcast_msg_t bcast_msg;
-	char *buffer = NULL;
-	int32_t orig_len = 0;
+	bcast_block_t *block;
+	pthread_t reader_tid;
+	int i, inx = 0;
 	uint64_t size_uncompressed = 0, size_compressed = 0;
 	uint32_t time_compression = 0;
-	bool more = true;
-	DEF_TIMERS;
 
 	if (params->block_size)
 		block_len = MIN(params->block_size, f_stat.st_size);
@@ -414,32 +480,50 @@ static int _bcast_file(struct bcast_parameters *params)
 		params->fanout = MAX_THREADS;
 	slurm_set_tree_width(MIN(MAX_THREADS, params->fanout));
 
-	while (more) {
-		START_TIMER;
-		bcast_msg.block_len = _next_block(params, &buffer, &orig_len,
-						  &more);
-		END_TIMER;
-		time_compression += DELTA_TIMER;
-		size_uncompressed += orig_len;
-		size_compressed += bcast_msg.block_len;
+	slurm_thread_create(&reader_tid, _block_reader, params);
+
+	while (1) {
+		slurm_mutex_lock(&block_mutex);
+		while (!block_slot_cnt)
+			slurm_cond_wait(&block_cond, &block_mutex);
+		slurm_mutex_unlock(&block_mutex);
+
+		block = &block_slot[inx];
+		time_compression += block->time_compression;
+		size_uncompressed += block->orig_len;
+		size_compressed += block->data_len;
+		bcast_msg.block_len = block->data_len;
 		debug("block %u, size %u", bcast_msg.block_no,
 		      bcast_msg.block_len);
-		bcast_msg.compress = params->compress;
-		bcast_msg.uncomp_len = orig_len;
-		bcast_msg.block = buffer;
-		if (!more)
+		bcast_msg.compress = block->compress;
+		bcast_msg.uncomp_len = block->orig_len;
+		bcast_msg.block = block->data;
+		if (!block->more)
 			bcast_msg.last_block = 1;
 
 		rc = _file_bcast(params, &bcast_msg, sbcast_cred);
+
+		/* the slot may be refilled by the reader once released */
+		slurm_mutex_lock(&block_mutex);
+		block_slot_cnt--;
+		if (rc != SLURM_SUCCESS)
+			block_abort = true;
+		slurm_cond_broadcast(&block_cond);
+		slurm_mutex_unlock(&block_mutex);
+
 		if (rc != SLURM_SUCCESS)
 			break;
 		if (bcast_msg.last_block)
 			break;	/* end of file */
 		bcast_msg.block_no++;
-		bcast_msg.block_offset += orig_len;
+		bcast_msg.block_offset += bcast_msg.uncomp_len;
+		inx = (inx + 1) % BCAST_BLOCK_SLOTS;
 	}
+	pthread_join(reader_tid, NULL);
+
 	xfree(bcast_msg.user_name);
-	xfree(buffer);
+	for (i = 0; i < BCAST_BLOCK_SLOTS; i++)
+		xfree(block_slot[i].buffer);
 
 	if (size_uncompressed && (params->compress != 0)) {
 		int64_t pct = (int64_t) size_uncompressed - size_compressed;
@@ -457,7 +541,6 @@ static int _bcast_file(struct bcast_parameters *params)
 	return rc;
 }
 
-
 static int _decompress_data_zlib(file_bcast_msg_t *req)
 {
 #if HAVE_LIBZ
@@ -57,6 +57,7 @@ slurmdb_assoc_rec_t *assoc_mgr_root_assoc = NULL;
 uint32_t g_qos_max_priority = 0;
 uint32_t g_assoc_max_priority = 0;
 uint32_t g_qos_count = 0;
+uint32_t g_qos_usage_gen = 0;
 uint32_t g_user_assoc_count = 0;
 uint32_t g_tres_count = 0;
 
@@ -1632,6 +1633,7 @@ static int _get_assoc_mgr_qos_list(void *db_conn, int enforce)
 	assoc_mgr_lock(&locks);
 
 	FREE_NULL_LIST(assoc_mgr_qos_list);
+	g_qos_usage_gen++;
 	assoc_mgr_qos_list = new_list;
 	new_list = NULL;
 
@@ -1890,7 +1892,9 @@ static int _refresh_assoc_mgr_qos_list(void *db_conn, int enforce)
 			qos_rec->usage = NULL;
 		}
 		list_iterator_destroy(itr);
+		/* Frees the usage of qos no longer in the database */
 		FREE_NULL_LIST(assoc_mgr_qos_list);
+		g_qos_usage_gen++;
 	}
 
 	assoc_mgr_qos_list = current_qos;
@@ -2078,6 +2082,7 @@ extern int assoc_mgr_fini(bool save_state)
 	FREE_NULL_LIST(assoc_mgr_tres_list);
 	FREE_NULL_LIST(assoc_mgr_res_list);
 	FREE_NULL_LIST(assoc_mgr_qos_list);
+	g_qos_usage_gen++;
 	FREE_NULL_LIST(assoc_mgr_user_list);
 	FREE_NULL_LIST(assoc_mgr_wckey_list);
 	if (assoc_mgr_tres_name_array) {
@@ -4732,8 +4737,10 @@ extern int assoc_mgr_update_qos(slurmdb_update_object_t *update, bool locked)
 						slurmdb_destroy_qos_rec);
 				list_remove(itr);
 				list_append(remove_list, rec);
-			} else
+			} else {
 				list_delete_item(itr);
+				g_qos_usage_gen++;
+			}
 
 			if (!assoc_mgr_assoc_list)
 				break;
@@ -4816,7 +4823,13 @@ extern int assoc_mgr_update_qos(slurmdb_update_object_t *update, bool locked)
 		while ((rec = list_next(itr)))
 			init_setup.remove_qos_notify(rec);
 		list_iterator_destroy(itr);
+
+		if (!locked)
+			assoc_mgr_lock(&locks);
 		FREE_NULL_LIST(remove_list);
+		g_qos_usage_gen++;
+		if (!locked)
+			assoc_mgr_unlock(&locks);
 	}
 
 	if (update_list) {
@@ -5998,6 +6011,7 @@ extern int load_assoc_mgr_state(bool only_tres)
 				break;
 			}
 			FREE_NULL_LIST(assoc_mgr_qos_list);
+			g_qos_usage_gen++;
 			assoc_mgr_qos_list = msg->my_list;
 			_post_qos_list(assoc_mgr_qos_list);
 			debug("Recovered %u qos",
@@ -113,6 +113,8 @@ extern slurmdb_assoc_rec_t *assoc_mgr_root_assoc;
 
 extern uint32_t g_qos_max_priority; /* max priority in all qos's */
 extern uint32_t g_qos_count; /* count used for generating qos bitstr's */
+extern uint32_t g_qos_usage_gen; /* changed whenever a qos usage may have
+				 * been freed, under the qos write lock */
 extern uint32_t g_user_assoc_count; /* Number of associations which are users */
 extern uint32_t g_tres_count; /* Number of TRES from the database
 			       * which also is the number of elements
@@ -97,8 +97,8 @@ struct eio_handle_components {
 static int          _poll_internal(struct pollfd *pfds, unsigned int nfds,
 				   time_t shutdown_time);
 static unsigned int _poll_setup_pollfds(struct pollfd *, eio_obj_t **, List);
-static void         _poll_dispatch(struct pollfd *, unsigned int, eio_obj_t **,
-		                   List objList);
+static void         _poll_dispatch(struct pollfd *, unsigned int, int,
+				   eio_obj_t **, List objList);
 static void         _poll_handle_event(short revents, eio_obj_t *obj,
 		                       List objList);
 
@@ -289,6 +289,7 @@ int eio_handle_mainloop(eio_handle_t *eio)
 	eio_obj_t    **map     = NULL;
 	unsigned int   maxnfds = 0, nfds = 0;
 	unsigned int   n       = 0;
+	int            nready  = 0;
 	time_t shutdown_time;
 
 	xassert (eio != NULL);
@@ -308,8 +309,7 @@ int eio_handle_mainloop(eio_handle_t *eio)
 		if (!pollfds)  /* Fix for CLANG false positive */
 			goto done;
 
-		debug4("eio: handling events for %d objects",
-		       list_count(eio->obj_list));
+		debug4("eio: handling events for %u objects", n);
 		nfds = _poll_setup_pollfds(pollfds, map, eio->obj_list);
 		if (nfds <= 0)
 			goto done;
@@ -327,14 +327,19 @@ int eio_handle_mainloop(eio_handle_t *eio)
 		slurm_mutex_lock(&eio->shutdown_mutex);
 		shutdown_time = eio->shutdown_time;
 		slurm_mutex_unlock(&eio->shutdown_mutex);
-		if (_poll_internal(pollfds, nfds, shutdown_time) < 0)
+		if ((nready = _poll_internal(pollfds, nfds, shutdown_time)) < 0)
 			goto error;
 
 		/* See if we've been told to shut down by eio_signal_shutdown */
-		if (pollfds[nfds-1].revents & POLLIN)
-			_eio_wakeup_handler(eio);
+		if ((nready > 0) && pollfds[nfds-1].revents) {
+			if (pollfds[nfds-1].revents & POLLIN)
+				_eio_wakeup_handler(eio);
+			nready--;
+		}
 
-		_poll_dispatch(pollfds, nfds - 1, map, eio->obj_list);
+		if (nready > 0)
+			_poll_dispatch(pollfds, nfds - 1, nready, map,
+				       eio->obj_list);
 
 		slurm_mutex_lock(&eio->shutdown_mutex);
 		shutdown_time = eio->shutdown_time;
@@ -427,14 +432,20 @@ static unsigned int _poll_setup_pollfds(struct pollfd *pfds, eio_obj_t *map[],
 	return nfds;
 }
 
-static void _poll_dispatch(struct pollfd *pfds, unsigned int nfds,
+/*
+ * Handle the nready objects poll() reported events for, stopping as soon
+ * as they are all found rather than scanning every pollfd
+ */
+static void _poll_dispatch(struct pollfd *pfds, unsigned int nfds, int nready,
 			   eio_obj_t *map[], List objList)
 {
 	int i;
 
-	for (i = 0; i < nfds; i++) {
-		if (pfds[i].revents > 0)
+	for (i = 0; (i < nfds) && (nready > 0); i++) {
+		if (pfds[i].revents > 0) {
 			_poll_handle_event(pfds[i].revents, map[i], objList);
+			nready--;
+		}
 	}
 }
 
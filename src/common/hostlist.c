@@ -300,7 +300,7 @@ static void          hostname_destroy(hostname_t);
 static int           hostname_suffix_is_valid(hostname_t);
 static int           hostname_suffix_width(hostname_t);
 
-static hostrange_t   hostrange_new(void);
+static hostrange_t   hostrange_new(const char *);
 static hostrange_t   hostrange_create_single(const char *);
 static hostrange_t   hostrange_create(char *, unsigned long, unsigned long,
 				      int);
@@ -504,6 +504,7 @@ static hostname_t hostname_create_dims(const char *hostname, int dims)
 	char *p;
 	int idx = 0;
 	int hostlist_base;
+	size_t len;
 
 	assert(hostname != NULL);
 
@@ -511,24 +512,25 @@ static hostname_t hostname_create_dims(const char *hostname, int dims)
 		dims = slurmdb_setup_cluster_name_dims();
 	hostlist_base = hostlist_get_base(dims);
 
-	if (!(hn = (hostname_t) malloc(sizeof(*hn))))
+	/*
+	 * The hostname and prefix strings are stored in the same allocation,
+	 * just after the object. The prefix is never longer than the
+	 * hostname, even when adjusted by hostrange_hn_within().
+	 */
+	len = strlen(hostname) + 1;
+	if (!(hn = (hostname_t) malloc(sizeof(*hn) + (len * 2))))
   		out_of_memory("hostname create");
 
 	idx = host_prefix_end(hostname, dims);
 
-	if (!(hn->hostname = strdup(hostname))) {
-		free(hn);
-		out_of_memory("hostname create");
-	}
+	hn->hostname = (char *) (hn + 1);
+	memcpy(hn->hostname, hostname, len);
+	hn->prefix = hn->hostname + len;
 
 	hn->num = 0;
-	hn->prefix = NULL;
 	hn->suffix = NULL;
-	if (idx == (strlen(hostname) - 1)) {
-		if ((hn->prefix = strdup(hostname)) == NULL) {
-			hostname_destroy(hn);
-			out_of_memory("hostname prefix create");
-		}
+	if (idx == (len - 2)) {
+		memcpy(hn->prefix, hostname, len);
 		return hn;
 	}
 
@@ -540,17 +542,10 @@ static hostname_t hostname_create_dims(const char *hostname, int dims)
 	hn->num = strtoul(hn->suffix, &p, hostlist_base);
 
 	if (*p == '\0') {
-		if (!(hn->prefix = malloc((idx + 2)))) {
-			hostname_destroy(hn);
-			out_of_memory("hostname prefix create");
-		}
 		memcpy(hn->prefix, hostname, idx + 1);
 		hn->prefix[idx + 1] = '\0';
 	} else {
-		if (!(hn->prefix = strdup(hostname))) {
-			hostname_destroy(hn);
-			out_of_memory("hostname prefix create");
-		}
+		memcpy(hn->prefix, hostname, len);
 		hn->suffix = NULL;
 	}
 
@@ -573,10 +568,7 @@ static void hostname_destroy(hostname_t hn)
 	if (hn == NULL)
 		return;
 	hn->suffix = NULL;
-	if (hn->hostname)
-		free(hn->hostname);
-	if (hn->prefix)
-		free(hn->prefix);
+	/* strings are allocated with the hostname, see hostname_create_dims() */
 	free(hn);
 }
 
@@ -602,13 +594,18 @@ static int hostname_suffix_width(hostname_t hn)
 
 /* ----[ hostrange_t functions ]---- */
 
-/* allocate a new hostrange object
+/* allocate a new hostrange object with a copy of prefix
+ * The prefix is stored in the same allocation, just after the object,
+ * so creating, copying and destroying ranges costs one malloc/free each.
  */
-static hostrange_t hostrange_new(void)
+static hostrange_t hostrange_new(const char *prefix)
 {
-	hostrange_t new = (hostrange_t) malloc(sizeof(*new));
+	size_t len = strlen(prefix) + 1;
+	hostrange_t new = (hostrange_t) malloc(sizeof(*new) + len);
 	if (!new)
 		out_of_memory("hostrange create");
+	new->prefix = (char *) (new + 1);
+	memcpy(new->prefix, prefix, len);
 	return new;
 }
 
@@ -621,23 +618,13 @@ static hostrange_t hostrange_create_single(const char *prefix)
 
 	assert(prefix != NULL);
 
-	if ((new = hostrange_new()) == NULL)
-		goto error1;
-
-	if ((new->prefix = strdup(prefix)) == NULL)
-		goto error2;
-
+	new = hostrange_new(prefix);
 	new->singlehost = 1;
 	new->lo = 0L;
 	new->hi = 0L;
 	new->width = 0;
 
 	return new;
-
-error2:
-	free(new);
-error1:
-	out_of_memory("hostrange create single");
 }
 
 
@@ -650,12 +637,7 @@ hostrange_create(char *prefix, unsigned long lo, unsigned long hi, int width)
 
 	assert(prefix != NULL);
 
-	if ((new = hostrange_new()) == NULL)
-		goto error1;
-
-	if ((new->prefix = strdup(prefix)) == NULL)
-		goto error2;
-
+	new = hostrange_new(prefix);
 	new->lo = lo;
 	new->hi = hi;
 	new->width = width;
@@ -663,11 +645,6 @@ hostrange_create(char *prefix, unsigned long lo, unsigned long hi, int width)
 	new->singlehost = 0;
 
 	return new;
-
-error2:
-	free(new);
-error1:
-	out_of_memory("hostrange create");
 }
 
 
@@ -702,8 +679,7 @@ static void hostrange_destroy(hostrange_t hr)
 {
 	if (hr == NULL)
 		return;
-	if (hr->prefix)
-		free(hr->prefix);
+	/* prefix is allocated with the hostrange, see hostrange_new() */
 	free(hr);
 }
 
@@ -1048,7 +1024,6 @@ static int hostrange_hn_within(hostrange_t hr, hostname_t hn, int dims)
 		if (ldiff > 0 && (strlen(hn->suffix) >= ldiff)) {
 			/* Tack on ldiff of the hostname's suffix to
 			 * that of it's prefix */
-			hn->prefix = realloc(hn->prefix, len2+ldiff+1);
 			strncat(hn->prefix, hn->suffix, ldiff);
 		} else if (ldiff < 0) {
 			/* strip off the ldiff here */
@@ -3423,6 +3398,38 @@ char *hostlist_next_range(hostlist_iterator_t i)
 	return buf;
 }
 
+int hostlist_iterator_range_remain(hostlist_iterator_t i,
+				   unsigned long *num, int *width)
+{
+	int cnt = 0;
+
+	assert(i != NULL);
+	assert(i->magic == HOSTLIST_MAGIC);
+	LOCK_HOSTLIST(i->hl);
+	if ((i->idx < i->hl->nranges) && (i->depth >= 0) &&
+	    !i->hr->singlehost) {
+		int dims = slurmdb_setup_cluster_name_dims();
+		if ((dims <= 1) || (i->hr->width != dims)) {
+			*num = i->hr->lo + i->depth;
+			*width = i->hr->width;
+			cnt = i->hr->hi - *num;
+		}
+	}
+	UNLOCK_HOSTLIST(i->hl);
+
+	return cnt;
+}
+
+void hostlist_iterator_skip(hostlist_iterator_t i, int cnt)
+{
+	assert(i != NULL);
+	assert(i->magic == HOSTLIST_MAGIC);
+	LOCK_HOSTLIST(i->hl);
+	assert((i->hr->lo + i->depth + cnt) <= i->hr->hi);
+	i->depth += cnt;
+	UNLOCK_HOSTLIST(i->hl);
+}
+
 int hostlist_remove(hostlist_iterator_t i)
 {
 	hostrange_t new;
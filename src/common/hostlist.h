@@ -451,6 +451,25 @@ char * hostlist_next(hostlist_iterator_t i);
 char * hostlist_next_range(hostlist_iterator_t i);
 
 
+/* hostlist_iterator_range_remain():
+ *
+ * Set num and width to the numeric suffix and zero padded width of the
+ * host last returned by hostlist_next(i).
+ *
+ * Returns the number of hosts following it in the same range, i.e. hosts
+ * with the same prefix and consecutive numeric suffixes, or 0 if there are
+ * none or the host has no numeric suffix (num and width are then unset).
+ */
+int hostlist_iterator_range_remain(hostlist_iterator_t i,
+				   unsigned long *num, int *width);
+
+/* hostlist_iterator_skip():
+ *
+ * Advance iterator i past the next cnt hosts, which must not be more than
+ * returned by hostlist_iterator_range_remain().
+ */
+void hostlist_iterator_skip(hostlist_iterator_t i, int cnt);
+
 /* hostlist_remove():
  * Removes the last host returned by hostlist iterator i
  *
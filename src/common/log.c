@@ -1141,6 +1141,13 @@ static void _log_msg(log_level_t level, bool sched, const char *fmt, va_list arg
 	char *msgbuf = NULL;
 	int priority = LOG_INFO;
 
+	/*
+	 * Format the basic message before taking log_lock so that threads
+	 * expanding long messages don't serialize on it. LOG_MACRO has
+	 * already checked the message is logged at this level somewhere.
+	 */
+	buf = vxstrfmt(fmt, args);
+
 	slurm_mutex_lock(&log_lock);
 
 	if (!LOG_INITIALIZED) {
@@ -1150,7 +1157,6 @@ static void _log_msg(log_level_t level, bool sched, const char *fmt, va_list arg
 
 	if (SCHED_LOG_INITIALIZED && sched &&
 	    (highest_sched_log_level > LOG_LEVEL_QUIET)) {
-		buf = vxstrfmt(fmt, args);
 		xlogfmtcat(&msgbuf, "[%M] %s%s%s", sched_log->fpfx, pfx, buf);
 		_log_printf(sched_log, sched_log->fbuf, sched_log->logfp,
 			    "sched: %s\n", msgbuf);
@@ -1215,12 +1221,6 @@ static void _log_msg(log_level_t level, bool sched, const char *fmt, va_list arg
 
 	}
 
-	if (!buf) {
-		/* format the basic message,
-		 * if not already done for scheduling log */
-		buf = vxstrfmt(fmt, args);
-	}
-
 	if (level <= log->opt.stderr_level) {
 
 		fflush(stdout);
@@ -84,6 +84,17 @@ int node_record_count = 0;		/* count in node_record_table_ptr */
 uint16_t *cr_node_num_cores = NULL;
 uint32_t *cr_node_cores_offset = NULL;
 
+/*
+ * Node names are normally configured as ranges, so consecutive node records
+ * mostly have the same prefix and consecutive numeric suffixes of the same
+ * width. node_seq_end[i] is the index of the last node record in such a run
+ * which includes node record i. Used to convert whole ranges of hostlists to
+ * bitmaps and back rather than one node name at a time. Built on demand.
+ */
+static int *node_seq_end = NULL;
+static int node_seq_cnt = 0;
+static pthread_mutex_t node_seq_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 /* Local function definitions */
 static int	_delete_config_record (void);
 #if _DEBUG
@@ -91,7 +102,13 @@ static void	_dump_hash (void);
 #endif
 static node_record_t *_find_node_record(char *name, bool test_alias,
 					bool log_missing);
+static int	_hostlist_set_bitmap(hostlist_t hl, bool best_effort,
+				     bitstr_t *bitmap, const char *caller);
 static void	_list_delete_config (void *config_entry);
+static int	_name_suffix(const char *name, int *prefix_len,
+			     unsigned long *num);
+static int *	_node_seq_get(void);
+static void	_node_seq_clear(void);
 static void _node_record_hash_identity (void* item, const char** key,
 					uint32_t* key_len);
 
@@ -169,6 +186,82 @@ static void _node_record_hash_identity (void* item, const char** key,
 	*key_len = strlen(node_ptr->name);
 }
 
+/*
+ * _name_suffix - parse the numeric suffix of a node name
+ * OUT prefix_len - length of the name before the numeric suffix
+ * OUT num - value of the numeric suffix
+ * RET count of digits in the numeric suffix, 0 if none or too long to parse
+ */
+static int _name_suffix(const char *name, int *prefix_len, unsigned long *num)
+{
+	int len, digits = 0;
+
+	if (!name)
+		return 0;
+	len = strlen(name);
+	while ((digits < len) && isdigit((int) name[len - digits - 1]))
+		digits++;
+	if ((digits == 0) || (digits > 9))
+		return 0;
+
+	*prefix_len = len - digits;
+	*num = strtoul(name + *prefix_len, NULL, 10);
+	return digits;
+}
+
+/* Return node_seq_end, building it first if the node table has changed */
+static int *_node_seq_get(void)
+{
+	int i, *seq_end, *digits, *prefix_len;
+	unsigned long *num;
+
+	slurm_mutex_lock(&node_seq_mutex);
+	if ((node_seq_cnt == node_record_count) || !node_record_table_ptr) {
+		seq_end = node_seq_end;
+		slurm_mutex_unlock(&node_seq_mutex);
+		return seq_end;
+	}
+
+	xfree(node_seq_end);
+	node_seq_cnt = node_record_count;
+	node_seq_end = xcalloc(node_record_count, sizeof(int));
+	digits = xcalloc(node_record_count, sizeof(int));
+	prefix_len = xcalloc(node_record_count, sizeof(int));
+	num = xcalloc(node_record_count, sizeof(unsigned long));
+	for (i = 0; i < node_record_count; i++) {
+		digits[i] = _name_suffix(node_record_table_ptr[i].name,
+					 &prefix_len[i], &num[i]);
+	}
+	for (i = node_record_count - 1; i >= 0; i--) {
+		if ((i + 1 < node_record_count) && digits[i] &&
+		    (digits[i] == digits[i + 1]) &&
+		    (prefix_len[i] == prefix_len[i + 1]) &&
+		    (num[i] + 1 == num[i + 1]) &&
+		    !strncmp(node_record_table_ptr[i].name,
+			     node_record_table_ptr[i + 1].name,
+			     prefix_len[i]))
+			node_seq_end[i] = node_seq_end[i + 1];
+		else
+			node_seq_end[i] = i;
+	}
+	xfree(digits);
+	xfree(prefix_len);
+	xfree(num);
+
+	seq_end = node_seq_end;
+	slurm_mutex_unlock(&node_seq_mutex);
+	return seq_end;
+}
+
+/* Discard node_seq_end after node records are added, renamed or purged */
+static void _node_seq_clear(void)
+{
+	slurm_mutex_lock(&node_seq_mutex);
+	xfree(node_seq_end);
+	node_seq_cnt = 0;
+	slurm_mutex_unlock(&node_seq_mutex);
+}
+
 /*
  * bitmap2hostlist - given a bitmap, build a hostlist
  * IN bitmap - bitmap pointer
@@ -178,7 +271,9 @@ static void _node_record_hash_identity (void* item, const char** key,
  */
 hostlist_t bitmap2hostlist (bitstr_t *bitmap)
 {
-	int i, first, last;
+	int i, j, first, last, digits, prefix_len, *seq_end = NULL;
+	unsigned long num;
+	char range[MAXHOSTNAMELEN + 32];
 	hostlist_t hl;
 
 	if (bitmap == NULL)
@@ -190,9 +285,28 @@ hostlist_t bitmap2hostlist (bitstr_t *bitmap)
 
 	last  = bit_fls(bitmap);
 	hl = hostlist_create(NULL);
+	if (slurmdb_setup_cluster_name_dims() <= 1)
+		seq_end = _node_seq_get();
 	for (i = first; i <= last; i++) {
 		if (bit_test(bitmap, i) == 0)
 			continue;
+		/* Push runs of consecutively numbered nodes as one range */
+		j = i;
+		if (seq_end) {
+			while ((j < seq_end[i]) && bit_test(bitmap, j + 1))
+				j++;
+		}
+		if ((j > i) &&
+		    (digits = _name_suffix(node_record_table_ptr[i].name,
+					   &prefix_len, &num)) &&
+		    (prefix_len < MAXHOSTNAMELEN)) {
+			snprintf(range, sizeof(range), "%.*s[%0*lu-%0*lu]",
+				 prefix_len, node_record_table_ptr[i].name,
+				 digits, num, digits, num + (j - i));
+			hostlist_push(hl, range);
+			i = j;
+			continue;
+		}
 		hostlist_push_host(hl, node_record_table_ptr[i].name);
 	}
 	return hl;
@@ -639,6 +753,7 @@ extern node_record_t *create_node_record(config_record_t *config_ptr,
 		rehash_node();
 	}
 	node_ptr = node_record_table_ptr + (node_record_count++);
+	_node_seq_clear();
 	node_ptr->name = xstrdup(node_name);
 	if (!node_hash_table)
 		node_hash_table = xhash_init(_node_record_hash_identity, NULL);
@@ -776,6 +891,7 @@ extern int init_node_conf (void)
 	node_record_count = 0;
 	xfree(node_record_table_ptr);
 	xhash_free(node_hash_table);
+	_node_seq_clear();
 
 	if (config_list)	/* delete defunct configuration entries */
 		(void) _delete_config_record ();
@@ -806,8 +922,69 @@ extern void node_fini2 (void)
 
 	xfree(node_record_table_ptr);
 	node_record_count = 0;
+	_node_seq_clear();
 }
 
+/*
+ * _hostlist_set_bitmap - set the bits of bitmap for the nodes in a hostlist
+ * IN hl - hostlist of node names
+ * IN best_effort - if set don't return an error on invalid node name entries
+ * IN/OUT bitmap - bitmap of node_record_count bits to set
+ * IN caller - function name for error messages
+ * RET 0 if no error, otherwise EINVAL
+ */
+static int _hostlist_set_bitmap(hostlist_t hl, bool best_effort,
+				bitstr_t *bitmap, const char *caller)
+{
+	int rc = SLURM_SUCCESS;
+	int inx, cnt, width, digits, prefix_len, hl_digits, *seq_end;
+	unsigned long num, hl_num, tmp;
+	char *name;
+	hostlist_iterator_t hi;
+	node_record_t *node_ptr;
+
+	seq_end = _node_seq_get();
+	hi = hostlist_iterator_create(hl);
+	while ((name = hostlist_next(hi))) {
+		node_ptr = _find_node_record(name, best_effort, true);
+		if (!node_ptr) {
+			error("%s: invalid node specified %s", caller, name);
+			if (!best_effort)
+				rc = EINVAL;
+			free(name);
+			continue;
+		}
+		inx = node_ptr - node_record_table_ptr;
+		bit_set(bitmap, inx);
+
+		/*
+		 * If the rest of this hostlist range names the node records
+		 * which follow this one, set them without looking them up.
+		 * The suffix of the hostlist entry must be the node name's
+		 * whole numeric suffix for the names to stay in step.
+		 */
+		if (!seq_end || (seq_end[inx] == inx) ||
+		    xstrcmp(name, node_ptr->name) ||
+		    !(cnt = hostlist_iterator_range_remain(hi, &hl_num,
+							    &width)) ||
+		    !(digits = _name_suffix(name, &prefix_len, &num)) ||
+		    (num != hl_num)) {
+			free(name);
+			continue;
+		}
+		for (hl_digits = 1, tmp = hl_num; tmp >= 10; tmp /= 10)
+			hl_digits++;
+		if (MAX(width, hl_digits) == digits) {
+			cnt = MIN(cnt, seq_end[inx] - inx);
+			bit_nset(bitmap, inx + 1, inx + cnt);
+			hostlist_iterator_skip(hi, cnt);
+		}
+		free(name);
+	}
+	hostlist_iterator_destroy(hi);
+
+	return rc;
+}
 
 /*
  * node_name2bitmap - given a node name regular expression, build a bitmap
@@ -822,7 +999,6 @@ extern int node_name2bitmap (char *node_names, bool best_effort,
 			     bitstr_t **bitmap)
 {
 	int rc = SLURM_SUCCESS;
-	char *this_node_name;
 	bitstr_t *my_bitmap;
 	hostlist_t host_list;
 
@@ -842,20 +1018,8 @@ extern int node_name2bitmap (char *node_names, bool best_effort,
 		return rc;
 	}
 
-	while ( (this_node_name = hostlist_shift (host_list)) ) {
-		node_record_t *node_ptr;
-		node_ptr = _find_node_record(this_node_name, best_effort, true);
-		if (node_ptr) {
-			bit_set (my_bitmap, (bitoff_t) (node_ptr -
-							node_record_table_ptr));
-		} else {
-			error ("node_name2bitmap: invalid node specified %s",
-			       this_node_name);
-			if (!best_effort)
-				rc = EINVAL;
-		}
-		free (this_node_name);
-	}
+	rc = _hostlist_set_bitmap(host_list, best_effort, my_bitmap,
+				  "node_name2bitmap");
 	hostlist_destroy (host_list);
 
 	return rc;
@@ -870,34 +1034,14 @@ extern int node_name2bitmap (char *node_names, bool best_effort,
  */
 extern int hostlist2bitmap (hostlist_t hl, bool best_effort, bitstr_t **bitmap)
 {
-	int rc = SLURM_SUCCESS;
 	bitstr_t *my_bitmap;
-	char *name;
-	hostlist_iterator_t hi;
 
 	FREE_NULL_BITMAP(*bitmap);
 	my_bitmap = (bitstr_t *) bit_alloc (node_record_count);
 	*bitmap = my_bitmap;
 
-	hi = hostlist_iterator_create(hl);
-	while ((name = hostlist_next(hi))) {
-		node_record_t *node_ptr;
-		node_ptr = _find_node_record(name, best_effort, true);
-		if (node_ptr) {
-			bit_set (my_bitmap, (bitoff_t) (node_ptr -
-							node_record_table_ptr));
-		} else {
-			error ("hostlist2bitmap: invalid node specified %s",
-			       name);
-			if (!best_effort)
-				rc = EINVAL;
-		}
-		free (name);
-	}
-
-	hostlist_iterator_destroy(hi);
-	return rc;
-
+	return _hostlist_set_bitmap(hl, best_effort, my_bitmap,
+				    "hostlist2bitmap");
 }
 
 /* Purge the contents of a node record */
@@ -935,6 +1079,7 @@ extern void rehash_node (void)
 	int i;
 	node_record_t *node_ptr = node_record_table_ptr;
 
+	_node_seq_clear();
 	xhash_free (node_hash_table);
 	node_hash_table = xhash_init(_node_record_hash_identity, NULL);
 	for (i = 0; i < node_record_count; i++, node_ptr++) {
@@ -43,6 +43,7 @@
 #include <fcntl.h>
 #include <pthread.h>
 #include <stdarg.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <sys/time.h>
 
@@ -63,6 +64,7 @@
 #include "src/common/uid.h"
 #include "src/common/xassert.h"
 #include "src/common/xmalloc.h"
+#include "src/common/xhash.h"
 #include "src/common/xstring.h"
 
 #ifndef __sbcast_cred_t_defined
@@ -89,12 +91,17 @@ typedef struct sbcast_cred sbcast_cred_t;		/* opaque data type */
  *
  */
 typedef struct {
-	time_t   ctime;		/* Time that the cred was created	*/
-	time_t   expiration;    /* Time at which cred is no longer good	*/
+	/* jobid, stepid and ctime are contiguous, they are the hash key */
 	uint32_t jobid;		/* Slurm job id for this credential	*/
 	uint32_t stepid;	/* Slurm step id for this credential	*/
+	time_t   ctime;		/* Time that the cred was created	*/
+	time_t   expiration;    /* Time at which cred is no longer good	*/
 } cred_state_t;
 
+#define CRED_STATE_KEY_LEN \
+	(offsetof(cred_state_t, ctime) + sizeof(time_t) - \
+	 offsetof(cred_state_t, jobid))
+
 /*
  * slurm job state information
  * tracks jobids for which all future credentials have been revoked
@@ -149,7 +156,10 @@ struct slurm_cred_context {
 	enum ctx_type type;	/* context type (creator or verifier)	*/
 	void *key;		/* private or public key		*/
 	List job_list;		/* List of used jobids (for verifier)	*/
+	xhash_t *job_hash;	/* job_list records indexed by jobid	*/
 	List state_list;	/* List of cred states (for verifier)	*/
+	xhash_t *state_hash;	/* state_list records indexed by
+				 * jobid, stepid and ctime		*/
 
 	int expiry_window;	/* expiration window for cached creds	*/
 
@@ -268,7 +278,8 @@ static void           _job_state_destroy(job_state_t   *js);
 
 static job_state_t  * _find_job_state(slurm_cred_ctx_t ctx, uint32_t jobid);
 static job_state_t  * _insert_job_state(slurm_cred_ctx_t ctx,  uint32_t jobid);
-static int            _find_cred_state(cred_state_t *c, slurm_cred_t *cred);
+static cred_state_t * _find_cred_state(slurm_cred_ctx_t ctx,
+				       slurm_cred_t *cred);
 
 static void _insert_cred_state(slurm_cred_ctx_t ctx, slurm_cred_t *cred);
 static void _clear_expired_job_states(slurm_cred_ctx_t ctx);
@@ -297,6 +308,9 @@ static void _cred_state_unpack(slurm_cred_ctx_t ctx, Buf buffer);
 static void _cred_state_pack(slurm_cred_ctx_t ctx, Buf buffer);
 static void _job_state_pack_one(job_state_t *j, Buf buffer);
 static void _cred_state_pack_one(cred_state_t *s, Buf buffer);
+static int  _list_find_cred_state(void *x, void *key);
+static void _job_state_id(void *item, const char **key, uint32_t *key_len);
+static void _cred_state_id(void *item, const char **key, uint32_t *key_len);
 
 static void _sbast_cache_add(sbcast_cred_t *sbcast_cred);
 static void _sbcast_cache_del(void *x);
@@ -461,6 +475,8 @@ slurm_cred_ctx_destroy(slurm_cred_ctx_t ctx)
 		(*(ops.cred_destroy_key))(ctx->exkey);
 	if (ctx->key)
 		(*(ops.cred_destroy_key))(ctx->key);
+	xhash_free(ctx->job_hash);
+	xhash_free(ctx->state_hash);
 	FREE_NULL_LIST(ctx->job_list);
 	FREE_NULL_LIST(ctx->state_list);
 
@@ -1041,6 +1057,7 @@ int
 slurm_cred_rewind(slurm_cred_ctx_t ctx, slurm_cred_t *cred)
 {
 	int rc = 0;
+	cred_state_t *s;
 
 	xassert(ctx != NULL);
 
@@ -1049,8 +1066,12 @@ slurm_cred_rewind(slurm_cred_ctx_t ctx, slurm_cred_t *cred)
 	xassert(ctx->magic == CRED_CTX_MAGIC);
 	xassert(ctx->type  == SLURM_CRED_VERIFIER);
 
-	rc = list_delete_all(ctx->state_list,
-			     (ListFindF) _find_cred_state, cred);
+	if ((s = _find_cred_state(ctx, cred))) {
+		xhash_delete(ctx->state_hash, (char *) &s->jobid,
+			     CRED_STATE_KEY_LEN);
+		rc = list_delete_all(ctx->state_list,
+				     _list_find_cred_state, cred);
+	}
 
 	slurm_mutex_unlock(&ctx->mutex);
 
@@ -1572,7 +1593,9 @@ _verifier_ctx_init(slurm_cred_ctx_t ctx)
 	xassert(ctx->type == SLURM_CRED_VERIFIER);
 
 	ctx->job_list   = list_create((ListDelF) _job_state_destroy);
+	ctx->job_hash   = xhash_init(_job_state_id, NULL);
 	ctx->state_list = list_create((ListDelF) _cred_state_destroy);
+	ctx->state_hash = xhash_init(_cred_state_id, NULL);
 
 	return;
 }
@@ -1857,6 +1880,24 @@ static int _list_find_cred_state(void *x, void *key)
 	return 0;
 }
 
+/* Fetch key from xhash_t item. Called from function ptr */
+static void _job_state_id(void *item, const char **key, uint32_t *key_len)
+{
+	job_state_t *j = (job_state_t *) item;
+
+	*key = (const char *) &j->jobid;
+	*key_len = sizeof(j->jobid);
+}
+
+/* Fetch key from xhash_t item. Called from function ptr */
+static void _cred_state_id(void *item, const char **key, uint32_t *key_len)
+{
+	cred_state_t *s = (cred_state_t *) item;
+
+	*key = (const char *) &s->jobid;
+	*key_len = CRED_STATE_KEY_LEN;
+}
+
 
 static bool
 _credential_replayed(slurm_cred_ctx_t ctx, slurm_cred_t *cred)
@@ -1865,7 +1906,7 @@ _credential_replayed(slurm_cred_ctx_t ctx, slurm_cred_t *cred)
 
 	_clear_expired_credential_states(ctx);
 
-	s = list_find_first(ctx->state_list, _list_find_cred_state, cred);
+	s = _find_cred_state(ctx, cred);
 
 	/*
 	 * If we found a match, this credential is being replayed.
@@ -1934,38 +1975,33 @@ _credential_revoked(slurm_cred_ctx_t ctx, slurm_cred_t *cred)
 	return false;
 }
 
-static int _list_find_job_state(void *x, void *key)
-{
-	job_state_t *j = (job_state_t *) x;
-	uint32_t jobid = *(uint32_t *) key;
-	if (j->jobid == jobid)
-		return 1;
-	return 0;
-}
-
 static job_state_t *
 _find_job_state(slurm_cred_ctx_t ctx, uint32_t jobid)
 {
-	job_state_t *j =
-		list_find_first(ctx->job_list, _list_find_job_state, &jobid);
-	return j;
+	return xhash_get(ctx->job_hash, (char *) &jobid, sizeof(jobid));
 }
 
-static int
-_find_cred_state(cred_state_t *c, slurm_cred_t *cred)
+static cred_state_t *
+_find_cred_state(slurm_cred_ctx_t ctx, slurm_cred_t *cred)
 {
-	return ((c->jobid == cred->jobid) && (c->stepid == cred->stepid) &&
-		(c->ctime == cred->ctime));
+	cred_state_t key;
+
+	key.jobid  = cred->jobid;
+	key.stepid = cred->stepid;
+	key.ctime  = cred->ctime;
+
+	return xhash_get(ctx->state_hash, (char *) &key.jobid,
+			 CRED_STATE_KEY_LEN);
 }
 
 static job_state_t *
 _insert_job_state(slurm_cred_ctx_t ctx, uint32_t jobid)
 {
-	job_state_t *j = list_find_first(
-		ctx->job_list, _list_find_job_state, &jobid);;
+	job_state_t *j = _find_job_state(ctx, jobid);
 	if (!j) {
 		j = _job_state_create(jobid);
 		list_append(ctx->job_list, j);
+		xhash_add(ctx->job_hash, j);
 	} else
 		debug2("%s: we already have a job state for job %u.  No big deal, just an FYI.",
 		       __func__, jobid);
@@ -2013,6 +2049,8 @@ _clear_expired_job_states(slurm_cred_ctx_t ctx)
 		       j->jobid, (uint64_t)j->ctime, (uint64_t)j->revoked,
 		       (uint64_t)j->expiration);
 		if (j->revoked && (now > j->expiration)) {
+			xhash_delete(ctx->job_hash, (char *) &j->jobid,
+				     sizeof(j->jobid));
 			list_delete_item(i);
 		}
 	}
@@ -2020,27 +2058,27 @@ _clear_expired_job_states(slurm_cred_ctx_t ctx)
 	list_iterator_destroy(i);
 }
 
-static int _list_find_expired(void *x, void *key)
-{
-	cred_state_t *s = (cred_state_t *)x;
-	time_t curr_time = *(time_t *)key;
-
-	if (curr_time > s->expiration)
-		return 1;
-	return 0;
-}
-
 static void
 _clear_expired_credential_states(slurm_cred_ctx_t ctx)
 {
 	static time_t last_scan = 0;
 	time_t        now = time(NULL);
+	ListIterator  i   = NULL;
+	cred_state_t *s   = NULL;
 
 	if ((now - last_scan) < 2)	/* Reduces slurmd overhead */
 		return;
 	last_scan = now;
 
-	list_delete_all(ctx->state_list, _list_find_expired, &now);
+	i = list_iterator_create(ctx->state_list);
+	while ((s = list_next(i))) {
+		if (now > s->expiration) {
+			xhash_delete(ctx->state_hash, (char *) &s->jobid,
+				     CRED_STATE_KEY_LEN);
+			list_delete_item(i);
+		}
+	}
+	list_iterator_destroy(i);
 }
 
 
@@ -2049,6 +2087,7 @@ _insert_cred_state(slurm_cred_ctx_t ctx, slurm_cred_t *cred)
 {
 	cred_state_t *s = _cred_state_create(ctx, cred);
 	list_append(ctx->state_list, s);
+	xhash_add(ctx->state_hash, s);
 }
 
 
@@ -2166,9 +2205,12 @@ _cred_state_unpack(slurm_cred_ctx_t ctx, Buf buffer)
 		if (!(s = _cred_state_unpack_one(buffer)))
 			goto unpack_error;
 
-		if (now < s->expiration)
+		if ((now < s->expiration) &&
+		    !xhash_get(ctx->state_hash, (char *) &s->jobid,
+			       CRED_STATE_KEY_LEN)) {
 			list_append(ctx->state_list, s);
-		else
+			xhash_add(ctx->state_hash, s);
+		} else
 			_cred_state_destroy(s);
 	}
 
@@ -2211,9 +2253,15 @@ _job_state_unpack(slurm_cred_ctx_t ctx, Buf buffer)
 		if (!(j = _job_state_unpack_one(buffer)))
 			goto unpack_error;
 
-		if (!j->revoked || (j->revoked && (now < j->expiration)))
+		if (_find_job_state(ctx, j->jobid)) {
+			debug3 ("not appending duplicate job %u state",
+			        j->jobid);
+			_job_state_destroy(j);
+		} else if (!j->revoked ||
+			   (j->revoked && (now < j->expiration))) {
 			list_append(ctx->job_list, j);
-		else {
+			xhash_add(ctx->job_hash, j);
+		} else {
 			debug3 ("not appending expired job %u state",
 			        j->jobid);
 			_job_state_destroy(j);
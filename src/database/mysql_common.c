@@ -181,6 +181,24 @@ end_it:
 	return rc;
 }
 
+/*
+ * Run a query that may change data. With rollback the first of those opens
+ * the transaction, so remember the server thread it ran on. A re-connect
+ * before the transaction ends then shows up as a different thread id, while
+ * one between transactions does not.
+ * NOTE: mysql_conn->lock must be set on function entry
+ */
+static int _mysql_query_trans(mysql_conn_t *mysql_conn, char *query)
+{
+	int rc = _mysql_query_internal(mysql_conn->db_conn, query);
+
+	if (mysql_conn->rollback && !mysql_conn->trans_thread_id)
+		mysql_conn->trans_thread_id =
+			mysql_thread_id(mysql_conn->db_conn);
+
+	return rc;
+}
+
 /* NOTE: Ensure that mysql_conn->lock is NOT set on function entry */
 static int _mysql_make_table_current(mysql_conn_t *mysql_conn, char *table_name,
 				     storage_field_t *fields, char *ending)
@@ -810,7 +828,7 @@ extern int mysql_db_query(mysql_conn_t *mysql_conn, char *query)
 		return 0;	/* For CLANG false positive */
 	}
 	slurm_mutex_lock(&mysql_conn->lock);
-	rc = _mysql_query_internal(mysql_conn->db_conn, query);
+	rc = _mysql_query_trans(mysql_conn, query);
 	slurm_mutex_unlock(&mysql_conn->lock);
 	return rc;
 }
@@ -828,7 +846,7 @@ extern int mysql_db_delete_affected_rows(mysql_conn_t *mysql_conn, char *query)
 		return 0;	/* For CLANG false positive */
 	}
 	slurm_mutex_lock(&mysql_conn->lock);
-	if (!(rc = _mysql_query_internal(mysql_conn->db_conn, query)))
+	if (!(rc = _mysql_query_trans(mysql_conn, query)))
 		rc = mysql_affected_rows(mysql_conn->db_conn);
 	slurm_mutex_unlock(&mysql_conn->lock);
 	return rc;
@@ -872,6 +890,7 @@ extern int mysql_db_commit(mysql_conn_t *mysql_conn)
 		errno = mysql_errno(mysql_conn->db_conn);
 		rc = SLURM_ERROR;
 	}
+	mysql_conn->trans_thread_id = 0;
 	slurm_mutex_unlock(&mysql_conn->lock);
 	return rc;
 }
@@ -899,6 +918,7 @@ extern int mysql_db_rollback(mysql_conn_t *mysql_conn)
 		 */
 		errno = 0;
 	}
+	mysql_conn->trans_thread_id = 0;
 	slurm_mutex_unlock(&mysql_conn->lock);
 	return rc;
 
@@ -939,8 +959,7 @@ extern int mysql_db_query_check_after(mysql_conn_t *mysql_conn, char *query)
 	int rc = SLURM_SUCCESS;
 
 	slurm_mutex_lock(&mysql_conn->lock);
-	if ((rc = _mysql_query_internal(
-		     mysql_conn->db_conn, query)) != SLURM_ERROR)
+	if ((rc = _mysql_query_trans(mysql_conn, query)) != SLURM_ERROR)
 		rc = _clear_results(mysql_conn->db_conn);
 	slurm_mutex_unlock(&mysql_conn->lock);
 	return rc;
@@ -951,7 +970,7 @@ extern uint64_t mysql_db_insert_ret_id(mysql_conn_t *mysql_conn, char *query)
 	uint64_t new_id = 0;
 
 	slurm_mutex_lock(&mysql_conn->lock);
-	if (_mysql_query_internal(mysql_conn->db_conn, query) != SLURM_ERROR)  {
+	if (_mysql_query_trans(mysql_conn, query) != SLURM_ERROR)  {
 		new_id = mysql_insert_id(mysql_conn->db_conn);
 		if (!new_id) {
 			/* should have new id */
@@ -65,6 +65,8 @@ typedef struct {
 	pthread_mutex_t lock;
 	char *pre_commit_query;
 	bool rollback;
+	unsigned long trans_thread_id; /* server thread of the open
+					* transaction, 0 if none */
 	List update_list;
 	int conn;
 } mysql_conn_t;
@@ -2746,6 +2746,7 @@ extern int acct_storage_p_close_connection(mysql_conn_t **mysql_conn)
 extern int acct_storage_p_commit(mysql_conn_t *mysql_conn, bool commit)
 {
 	int rc = check_connection(mysql_conn);
+	int commit_rc = SLURM_SUCCESS;
 
 	/* always reset this here */
 	if (mysql_conn)
@@ -2763,9 +2764,23 @@ extern int acct_storage_p_commit(mysql_conn_t *mysql_conn, bool commit)
 	debug4("got %d commits", list_count(mysql_conn->update_list));
 
 	if (mysql_conn->rollback) {
+		unsigned long thread_id = mysql_thread_id(mysql_conn->db_conn);
+
 		if (!commit) {
 			if (mysql_db_rollback(mysql_conn))
 				error("rollback failed");
+		} else if (mysql_conn->trans_thread_id &&
+			   (mysql_conn->trans_thread_id != thread_id)) {
+			/*
+			 * The connection was re-established (e.g. by
+			 * MYSQL_OPT_RECONNECT) after the first statement of
+			 * the transaction, so the server discarded what was
+			 * done before that.
+			 */
+			error("database connection was reset during the transaction, not committing");
+			if (mysql_db_rollback(mysql_conn))
+				error("rollback failed");
+			commit_rc = ESLURM_DB_CONNECTION;
 		} else {
 			int rc = SLURM_SUCCESS;
 			/*
@@ -2784,13 +2799,18 @@ extern int acct_storage_p_commit(mysql_conn_t *mysql_conn, bool commit)
 			if (rc != SLURM_SUCCESS) {
 				if (mysql_db_rollback(mysql_conn))
 					error("rollback failed");
-			} else {
-				if (mysql_db_commit(mysql_conn))
-					error("commit failed");
+				commit_rc = rc;
+			} else if (mysql_db_commit(mysql_conn)) {
+				error("commit failed");
+				commit_rc = SLURM_ERROR;
 			}
 		}
 	}
 
+	/* Nothing was committed, so don't push out its updates */
+	if (commit_rc != SLURM_SUCCESS)
+		commit = false;
+
 	if (commit && list_count(mysql_conn->update_list)) {
 		char *query = NULL;
 		MYSQL_RES *result = NULL;
@@ -2854,7 +2874,7 @@ extern int acct_storage_p_commit(mysql_conn_t *mysql_conn, bool commit)
 	xfree(mysql_conn->pre_commit_query);
 	list_flush(mysql_conn->update_list);
 
-	return SLURM_SUCCESS;
+	return commit_rc;
 }
 
 extern int acct_storage_p_add_users(mysql_conn_t *mysql_conn, uint32_t uid,
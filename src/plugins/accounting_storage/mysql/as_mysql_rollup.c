@@ -42,6 +42,7 @@
 #include "as_mysql_archive.h"
 #include "src/common/parse_time.h"
 #include "src/common/slurm_time.h"
+#include "src/common/xhash.h"
 
 enum {
 	TIME_ALLOC,
@@ -136,14 +137,35 @@ static int _find_loc_tres(void *x, void *key)
 	return 0;
 }
 
-static int _find_id_usage(void *x, void *key)
+/* Fetch key from xhash_t item. Called from function ptr */
+static void _id_usage_key_id(void *item, const char **key, uint32_t *key_len)
 {
-	local_id_usage_t *loc = (local_id_usage_t *)x;
-	uint32_t id = *(uint32_t *)key;
+	local_id_usage_t *usage = (local_id_usage_t *)item;
 
-	if (loc->id == id)
-		return 1;
-	return 0;
+	xassert(usage);
+
+	*key = (char *)&usage->id;
+	*key_len = sizeof(usage->id);
+}
+
+/*
+ * Allocate new id usage and add it to both usage_list (which owns it) and
+ * map, so it can be found again without scanning the list.
+ */
+static local_id_usage_t *_id_usage_add(List usage_list, xhash_t *map, int id)
+{
+	local_id_usage_t *usage = xmalloc(sizeof(local_id_usage_t));
+
+	usage->id = id;
+	list_append(usage_list, usage);
+	xhash_add(map, usage);
+
+	return usage;
+}
+
+static local_id_usage_t *_id_usage_find(xhash_t *map, int id)
+{
+	return xhash_get(map, (char *)&id, sizeof(id));
 }
 
 static void _remove_job_tres_time_from_cluster(List c_tres, List j_tres,
@@ -967,6 +989,13 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 	List cluster_down_list = list_create(_destroy_local_cluster_usage);
 	List wckey_usage_list = list_create(_destroy_local_id_usage);
 	List resv_usage_list = list_create(_destroy_local_resv_usage);
+	/*
+	 * Hash the id usage records by id so that finding the usage of a given
+	 * wckey for every job, or of every association able to run in a
+	 * reservation, doesn't scan the whole list. The lists own the records.
+	 */
+	xhash_t *assoc_usage_map = xhash_init(_id_usage_key_id, NULL);
+	xhash_t *wckey_usage_map = xhash_init(_id_usage_key_id, NULL);
 	uint16_t track_wckey = slurm_get_track_wckey();
 	local_cluster_usage_t *loc_c_usage = NULL;
 	local_cluster_usage_t *c_usage = NULL;
@@ -1304,9 +1333,9 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 			}
 
 			if (last_id != assoc_id) {
-				a_usage = xmalloc(sizeof(local_id_usage_t));
-				a_usage->id = assoc_id;
-				list_append(assoc_usage_list, a_usage);
+				a_usage = _id_usage_add(assoc_usage_list,
+							assoc_usage_map,
+							assoc_id);
 				last_id = assoc_id;
 				/* a_usage->loc_tres is made later,
 				   don't do it here.
@@ -1319,17 +1348,11 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 
 			/* do the wckey calculation */
 			if (last_wckeyid != wckey_id) {
-				list_iterator_reset(w_itr);
-				while ((w_usage = list_next(w_itr)))
-					if (w_usage->id == wckey_id)
-						break;
-
-				if (!w_usage) {
-					w_usage = xmalloc(
-						sizeof(local_id_usage_t));
-					w_usage->id = wckey_id;
-					list_append(wckey_usage_list,
-						    w_usage);
+				if (!(w_usage = _id_usage_find(wckey_usage_map,
+							       wckey_id))) {
+					w_usage = _id_usage_add(
+						wckey_usage_list,
+						wckey_usage_map, wckey_id);
 					w_usage->loc_tres = list_create(
 						_destroy_local_tres_usage);
 				}
@@ -1561,15 +1584,13 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 				while ((assoc = list_next(tmp_itr))) {
 					uint32_t associd = slurm_atoul(assoc);
 					if ((last_id != associd) &&
-					    !(a_usage = list_find_first(
-						      assoc_usage_list,
-						      _find_id_usage,
-						      &associd))) {
-						a_usage = xmalloc(
-							sizeof(local_id_usage_t));
-						a_usage->id = associd;
-						list_append(assoc_usage_list,
-							    a_usage);
+					    !(a_usage = _id_usage_find(
+						      assoc_usage_map,
+						      associd))) {
+						a_usage = _id_usage_add(
+							assoc_usage_list,
+							assoc_usage_map,
+							associd);
 						last_id = associd;
 						a_usage->loc_tres = list_create(
 							_destroy_local_tres_usage);
@@ -1662,6 +1683,8 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 		a_usage     = NULL;
 		w_usage     = NULL;
 
+		xhash_clear(assoc_usage_map);
+		xhash_clear(wckey_usage_map);
 		list_flush(assoc_usage_list);
 		list_flush(cluster_down_list);
 		list_flush(wckey_usage_list);
@@ -1685,6 +1708,8 @@ end_it:
 	if (r_itr)
 		list_iterator_destroy(r_itr);
 
+	xhash_free(assoc_usage_map);
+	xhash_free(wckey_usage_map);
 	FREE_NULL_LIST(assoc_usage_list);
 	FREE_NULL_LIST(cluster_down_list);
 	FREE_NULL_LIST(wckey_usage_list);
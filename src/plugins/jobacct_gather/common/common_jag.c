@@ -42,7 +42,6 @@
 #include <fcntl.h>
 #include <signal.h>
 #include <time.h>
-#include <ctype.h>
 
 #include "src/common/slurm_xlator.h"
 #include "src/common/assoc_mgr.h"
@@ -78,6 +77,112 @@ static DIR  *slash_proc = NULL;
 static int energy_profile = ENERGY_DATA_NODE_ENERGY_UP;
 static uint64_t debug_flags = 0;
 
+/*
+ * Open a /proc file for reading, closed on exec() of user tasks.
+ *
+ * Using open() with O_CLOEXEC rather than fopen() followed by fcntl() avoids
+ * both the stdio buffer allocation for every file read on every poll and the
+ * window in which a forked task could inherit the descriptor.
+ */
+static int _open_proc_file(const char *filename)
+{
+	return open(filename, O_RDONLY | O_CLOEXEC);
+}
+
+/*
+ * Read up to size - 1 bytes from fd into buf and NUL terminate it.
+ * RET number of bytes read, <= 0 on error or EOF
+ */
+static ssize_t _read_proc_buf(int fd, char *buf, size_t size)
+{
+	ssize_t num_read;
+
+	do {
+		num_read = read(fd, buf, size - 1);
+	} while ((num_read < 0) && (errno == EINTR));
+
+	if (num_read > 0)
+		buf[num_read] = '\0';
+
+	return num_read;
+}
+
+/*
+ * Hand rolled replacements for sscanf("%"SCNu64), sscanf("%lu") and
+ * sscanf("%ld"), which are by far the most expensive part of parsing
+ * /proc/<pid>/stat for every process on every poll. Leading blanks are
+ * skipped and *str is advanced past the number parsed.
+ * Use _scan_u64() for counters that can exceed 32 bits (/proc/<pid>/io,
+ * smaps), _scan_ul() and _scan_l() only for fields the kernel prints as
+ * %lu or %ld.
+ * RET true if a number was found
+ */
+static inline bool _scan_u64(char **str, uint64_t *val)
+{
+	char *p = *str;
+	uint64_t v = 0;
+
+	while ((*p == ' ') || (*p == '\t') || (*p == '\n'))
+		p++;
+	if ((*p < '0') || (*p > '9'))
+		return false;
+	while ((*p >= '0') && (*p <= '9'))
+		v = (v * 10) + (*p++ - '0');
+
+	*val = v;
+	*str = p;
+	return true;
+}
+
+static inline bool _scan_ul(char **str, unsigned long *val)
+{
+	uint64_t v;
+
+	if (!_scan_u64(str, &v))
+		return false;
+
+	*val = (unsigned long) v;
+	return true;
+}
+
+static inline bool _scan_l(char **str, long *val)
+{
+	char *p = *str;
+	unsigned long v;
+	bool neg = false;
+
+	while ((*p == ' ') || (*p == '\t') || (*p == '\n'))
+		p++;
+	if (*p == '-') {
+		neg = true;
+		p++;
+	}
+	if (!_scan_ul(&p, &v))
+		return false;
+
+	*val = neg ? -(long) v : (long) v;
+	*str = p;
+	return true;
+}
+
+/* Skip cnt blank separated fields of str */
+static inline bool _skip_fields(char **str, int cnt)
+{
+	char *p = *str;
+
+	while (cnt--) {
+		while ((*p == ' ') || (*p == '\t') || (*p == '\n'))
+			p++;
+		if (!*p)
+			return false;
+		while (*p && (*p != ' ') && (*p != '\t') && (*p != '\n'))
+			p++;
+	}
+
+	*str = p;
+	return true;
+}
+
 static int _find_prec(void *x, void *key)
 {
 	jag_prec_t *prec = (jag_prec_t *) x;
@@ -148,17 +253,17 @@ static int _get_pss(char *proc_smaps_file, jag_prec_t *prec)
 {
         uint64_t pss;
 	uint64_t p;
-        char line[128];
+        char line[128], *ptr;
         FILE *fp;
-	int i;
+	int fd;
 
-	fp = fopen(proc_smaps_file, "r");
-        if (!fp) {
-                return -1;
-        }
+	if ((fd = _open_proc_file(proc_smaps_file)) < 0)
+		return -1;
+	if (!(fp = fdopen(fd, "r"))) {
+		close(fd);
+		return -1;
+	}
 
-	if (fcntl(fileno(fp), F_SETFD, FD_CLOEXEC) == -1)
-		error("%s: fcntl(%s): %m", __func__, proc_smaps_file);
 	pss = 0;
 
         while (fgets(line,sizeof(line),fp)) {
@@ -167,16 +272,9 @@ static int _get_pss(char *proc_smaps_file, jag_prec_t *prec)
                         continue;
                 }
 
-                for (i = 4; i < sizeof(line); i++) {
-
-                        if (!isdigit(line[i])) {
-                                continue;
-                        }
-                        if (sscanf(&line[i],"%"PRIu64"", &p) == 1) {
-                                pss += p;
-                        }
-                        break;
-                }
+		ptr = line + 4;
+		if (_scan_u64(&ptr, &p))
+			pss += p;
         }
 
 	/* Check for error
@@ -314,54 +412,47 @@ again:
  *
  * Based upon stat2proc() from the ps command. It can handle arbitrary
  * executable file basenames for `cmd', i.e. those with embedded whitespace or
- * embedded ')'s. Such names confuse %s (see scanf(3)), so the string is split
- * and %39c is used instead. (except for embedded ')' "(%[^)]c)" would work.
+ * embedded ')'s: the line is split at the last ')', and the fields after it
+ * are walked with _skip_fields(), only those recorded being converted with
+ * _scan_l() and _scan_ul().
  */
 static int _get_process_data_line(int in, jag_prec_t *prec) {
 	char sbuf[512], *tmp;
-	int num_read, nvals;
-	char cmd[40], state[1];
-	int ppid, pgrp, session, tty_nr, tpgid;
-	long unsigned flags, minflt, cminflt, majflt, cmajflt;
-	long unsigned utime, stime, starttime, vsize;
-	long int cutime, cstime, priority, nice, timeout, itrealvalue, rss;
-	long unsigned f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13;
-	int exit_signal, last_cpu;
-
-	num_read = read(in, sbuf, (sizeof(sbuf) - 1));
-	if (num_read <= 0)
+	long ppid, rss, last_cpu;
+	unsigned long majflt, utime, stime, vsize;
+
+	if (_read_proc_buf(in, sbuf, sizeof(sbuf)) <= 0)
 		return 0;
-	sbuf[num_read] = '\0';
 
 	/*
 	 * split into "PID (cmd" and "<rest>" replace trailing ')' with NULL
 	 */
 	tmp = strrchr(sbuf, ')');
-	if (!tmp)
+	if (!tmp || !strchr(sbuf, '('))
 		return 0;
 	*tmp = '\0';
+	prec->pid = atoi(sbuf);
 
-	/* parse these two strings separately, skipping the leading "(". */
-	nvals = sscanf(sbuf, "%d (%39c", &prec->pid, cmd);
-	if (nvals < 2)
+	/*
+	 * Field numbers below are those of proc(5), "cmd" being field 2.
+	 * Only the fields slurm records are converted, the rest are skipped.
+	 */
+	tmp += 2;	/* skip space after ')' too */
+	if (!_skip_fields(&tmp, 1) ||		/* 3 state */
+	    !_scan_l(&tmp, &ppid) ||		/* 4 ppid */
+	    !_skip_fields(&tmp, 7) ||		/* 5-11 pgrp to cminflt */
+	    !_scan_ul(&tmp, &majflt) ||		/* 12 majflt */
+	    !_skip_fields(&tmp, 1) ||		/* 13 cmajflt */
+	    !_scan_ul(&tmp, &utime) ||		/* 14 utime */
+	    !_scan_ul(&tmp, &stime) ||		/* 15 stime */
+	    !_skip_fields(&tmp, 7) ||		/* 16-22 cutime to starttime */
+	    !_scan_ul(&tmp, &vsize) ||		/* 23 vsize */
+	    !_scan_l(&tmp, &rss) ||		/* 24 rss */
+	    !_skip_fields(&tmp, 14) ||		/* 25-38 rsslim to exit_signal */
+	    !_scan_l(&tmp, &last_cpu))		/* 39 processor */
 		return 0;
-
-	nvals = sscanf(tmp + 2,	 /* skip space after ')' too */
-		       "%c %d %d %d %d %d "
-		       "%lu %lu %lu %lu %lu "
-		       "%lu %lu %ld %ld %ld %ld "
-		       "%ld %ld %lu %lu %ld "
-		       "%lu %lu %lu %lu %lu "
-		       "%lu %lu %lu %lu %lu "
-		       "%lu %lu %lu %d %d ",
-		       state, &ppid, &pgrp, &session, &tty_nr, &tpgid,
-		       &flags, &minflt, &cminflt, &majflt, &cmajflt,
-		       &utime, &stime, &cutime, &cstime, &priority, &nice,
-		       &timeout, &itrealvalue, &starttime, &vsize, &rss,
-		       &f1, &f2, &f3, &f4, &f5 ,&f6, &f7, &f8, &f9, &f10, &f11,
-		       &f12, &f13, &exit_signal, &last_cpu);
 	/* There are some additional fields, which we do not scan or use */
-	if ((nvals < 37) || (rss < 0))
+	if (rss < 0)
 		return 0;
 
 	/* If current pid corresponds to a Light Weight Process (Thread POSIX) */
@@ -401,21 +492,16 @@ static int _get_process_data_line(int in, jag_prec_t *prec) {
  */
 static int _get_process_memory_line(int in, jag_prec_t *prec)
 {
-	char sbuf[256];
-	int num_read, nvals;
-	long int size, rss, share, text, lib, data, dt;
+	char sbuf[256], *tmp = sbuf;
+	long int size, rss, share;
 
-	num_read = read(in, sbuf, (sizeof(sbuf) - 1));
-	if (num_read <= 0)
+	if (_read_proc_buf(in, sbuf, sizeof(sbuf)) <= 0)
 		return 0;
-	sbuf[num_read] = '\0';
 
-	nvals = sscanf(sbuf,
-		       "%ld %ld %ld %ld %ld %ld %ld",
-		       &size, &rss, &share, &text, &lib, &data, &dt);
-	/* There are some additional fields, which we do not scan or use */
-	if (nvals != 7)
+	if (!_scan_l(&tmp, &size) || !_scan_l(&tmp, &rss) ||
+	    !_scan_l(&tmp, &share))
 		return 0;
+	/* There are some additional fields, which we do not scan or use */
 
 	/* If shared > rss then there is a problem, give up... */
 	if (share > rss) {
@@ -432,19 +518,15 @@ static int _get_process_memory_line(int in, jag_prec_t *prec)
 
 static int _remove_share_data(char *proc_stat_file, jag_prec_t *prec)
 {
-	FILE *statm_fp = NULL;
 	char proc_statm_file[256];	/* Allow ~20x extra length */
 	int rc = 0, fd;
 
 	snprintf(proc_statm_file, sizeof(proc_statm_file), "%sm",
 		 proc_stat_file);
-	if (!(statm_fp = fopen(proc_statm_file, "r")))
+	if ((fd = _open_proc_file(proc_statm_file)) < 0)
 		return rc;  /* Assume the process went away */
-	fd = fileno(statm_fp);
-	if (fcntl(fd, F_SETFD, FD_CLOEXEC) == -1)
-		error("%s: fcntl(%s): %m", __func__, proc_statm_file);
 	rc = _get_process_memory_line(fd, prec);
-	fclose(statm_fp);
+	close(fd);
 	return rc;
 }
 
@@ -462,22 +544,18 @@ static int _remove_share_data(char *proc_stat_file, jag_prec_t *prec)
  *   . . .
  */
 static int _get_process_io_data_line(int in, jag_prec_t *prec) {
-	char sbuf[256];
-	char f1[7], f3[7];
-	int num_read, nvals;
+	char sbuf[256], *tmp = sbuf;
 	uint64_t rchar, wchar;
 
-	num_read = read(in, sbuf, (sizeof(sbuf) - 1));
-	if (num_read <= 0)
-		return 0;
-	sbuf[num_read] = '\0';
-
-	nvals = sscanf(sbuf, "%s %"PRIu64" %s %"PRIu64"",
-		       f1, &rchar, f3, &wchar);
-	if (nvals < 4)
+	if (_read_proc_buf(in, sbuf, sizeof(sbuf)) <= 0)
 		return 0;
 
-	if (_is_a_lwp(prec->pid) > 0)
+	/*
+	 * Light weight processes were already filtered out when
+	 * /proc/<pid>/stat was read, no need to read /proc/<pid>/status again.
+	 */
+	if (!_skip_fields(&tmp, 1) || !_scan_u64(&tmp, &rchar) ||
+	    !_skip_fields(&tmp, 1) || !_scan_u64(&tmp, &wchar))
 		return 0;
 
 	/* keep real value here since we aren't doubles */
@@ -494,8 +572,6 @@ static void _handle_stats(List prec_list, char *proc_stat_file,
 {
 	static int no_share_data = -1;
 	static int use_pss = -1;
-	FILE *stat_fp = NULL;
-	FILE *io_fp = NULL;
 	int fd, fd2, i;
 	jag_prec_t *prec = NULL;
 
@@ -513,21 +589,8 @@ static void _handle_stats(List prec_list, char *proc_stat_file,
 		xfree(acct_params);
 	}
 
-	if (!(stat_fp = fopen(proc_stat_file, "r")))
+	if ((fd = _open_proc_file(proc_stat_file)) < 0)
 		return;  /* Assume the process went away */
-	/*
-	 * Close the file on exec() of user tasks.
-	 *
-	 * NOTE: If we fork() slurmstepd after the
-	 * fopen() above and before the fcntl() below,
-	 * then the user task may have this extra file
-	 * open, which can cause problems for
-	 * checkpoint/restart, but this should be a very rare
-	 * problem in practice.
-	 */
-	fd = fileno(stat_fp);
-	if (fcntl(fd, F_SETFD, FD_CLOEXEC) == -1)
-		error("%s: fcntl(%s): %m", __func__, proc_stat_file);
 
 	prec = xmalloc(sizeof(jag_prec_t));
 
@@ -555,10 +618,10 @@ static void _handle_stats(List prec_list, char *proc_stat_file,
 	if (!_get_process_data_line(fd, prec)) {
 		xfree(prec->tres_data);
 		xfree(prec);
-		fclose(stat_fp);
+		close(fd);
 		return;
 	}
-	fclose(stat_fp);
+	close(fd);
 
 	if (acct_gather_filesystem_g_get_data(prec->tres_data) < 0) {
 		debug2("problem retrieving filesystem data");
@@ -583,12 +646,9 @@ static void _handle_stats(List prec_list, char *proc_stat_file,
 
 	list_append(prec_list, prec);
 
-	if ((io_fp = fopen(proc_io_file, "r"))) {
-		fd2 = fileno(io_fp);
-		if (fcntl(fd2, F_SETFD, FD_CLOEXEC) == -1)
-			error("%s: fcntl: %m", __func__);
+	if ((fd2 = _open_proc_file(proc_io_file)) >= 0) {
 		_get_process_io_data_line(fd2, prec);
-		fclose(io_fp);
+		close(fd2);
 	}
 }
 
@@ -38,6 +38,7 @@
 #include "dist_tasks.h"
 
 #include "src/common/node_select.h"
+#include "src/common/xhash.h"
 #include "src/common/xstring.h"
 
 #include "src/slurmctld/preempt.h"
@@ -161,12 +162,13 @@ static int _cr_job_list_sort(void *x, void *y)
 	return (int) SLURM_DIFFTIME(job1_ptr->end_time, job2_ptr->end_time);
 }
 
-static int _find_job (void *x, void *key)
+/* Fetch key from xhash_t item. Called from function ptr */
+static void _job_id_key(void *item, const char **key, uint32_t *key_len)
 {
-	job_record_t *job_ptr = (job_record_t *) x;
-	if (job_ptr == (job_record_t *) key)
-		return 1;
-	return 0;
+	job_record_t *job_ptr = (job_record_t *) item;
+
+	*key = (char *) &job_ptr->job_id;
+	*key_len = sizeof(job_ptr->job_id);
 }
 
 extern void _free_avail_res_array(avail_res_t **avail_res_array)
@@ -414,11 +416,34 @@ static int _is_node_busy(part_res_record_t *p_ptr, uint32_t node_i,
 	return 0;
 }
 
-static bool _is_preemptable(job_record_t *job_ptr, List preemptee_candidates)
+/*
+ * Index the preemption candidates by job id so that testing every running
+ * job against them is not quadratic. Caller must xhash_free() the result.
+ */
+static xhash_t *_build_preemptee_hash(List preemptee_candidates)
 {
+	xhash_t *preemptee_hash;
+	ListIterator iter;
+	job_record_t *job_ptr;
+
 	if (!preemptee_candidates)
+		return NULL;
+
+	preemptee_hash = xhash_init(_job_id_key, NULL);
+	iter = list_iterator_create(preemptee_candidates);
+	while ((job_ptr = list_next(iter)))
+		xhash_add(preemptee_hash, job_ptr);
+	list_iterator_destroy(iter);
+
+	return preemptee_hash;
+}
+
+static bool _is_preemptable(job_record_t *job_ptr, xhash_t *preemptee_hash)
+{
+	if (!preemptee_hash)
 		return false;
-	if (list_find_first(preemptee_candidates, _find_job, job_ptr))
+	if (xhash_get(preemptee_hash, (char *) &job_ptr->job_id,
+		      sizeof(job_ptr->job_id)) == job_ptr)
 		return true;
 	return false;
 }
@@ -1740,6 +1765,7 @@ static int _will_run_test(job_record_t *job_ptr, bitstr_t *node_bitmap,
 	job_record_t *tmp_job_ptr;
 	List cr_job_list;
 	ListIterator job_iterator, preemptee_iterator;
+	xhash_t *preemptee_hash;
 	bitstr_t *orig_map;
 	int action, rc = SLURM_ERROR;
 	time_t now = time(NULL);
@@ -1787,6 +1813,7 @@ static int _will_run_test(job_record_t *job_ptr, bitstr_t *node_bitmap,
 
 	/* Build list of running and suspended jobs */
 	cr_job_list = list_create(NULL);
+	preemptee_hash = _build_preemptee_hash(preemptee_candidates);
 	job_iterator = list_iterator_create(job_list);
 	while ((tmp_job_ptr = list_next(job_iterator))) {
 		if (!IS_JOB_RUNNING(tmp_job_ptr) &&
@@ -1806,7 +1833,7 @@ static int _will_run_test(job_record_t *job_ptr, bitstr_t *node_bitmap,
 			      plugin_type, __func__, tmp_job_ptr);
 			continue;
 		}
-		if (!_is_preemptable(tmp_job_ptr, preemptee_candidates)) {
+		if (!_is_preemptable(tmp_job_ptr, preemptee_hash)) {
 			/* Queue job for later removal from data structures */
 			list_append(cr_job_list, tmp_job_ptr);
 		} else {
@@ -1826,6 +1853,7 @@ static int _will_run_test(job_record_t *job_ptr, bitstr_t *node_bitmap,
 		}
 	}
 	list_iterator_destroy(job_iterator);
+	xhash_free(preemptee_hash);
 
 	/* Test with all preemptable jobs gone */
 	if (preemptee_candidates) {
@@ -2259,6 +2259,15 @@ static int _eval_nodes_topo(job_record_t *job_ptr,
 		switch_node_bitmap[i] = bit_copy(switch_ptr->node_bitmap);
 		bit_and(switch_node_bitmap[i], node_map);
 		switch_node_cnt[i] = bit_set_count(switch_node_bitmap[i]);
+		if (switch_node_cnt[i] == 0) {
+			/*
+			 * Nothing available on this switch and later passes
+			 * only remove nodes, so drop its bitmap and skip it
+			 * from here on. On a busy cluster this is most leaves.
+			 */
+			FREE_NULL_BITMAP(switch_node_bitmap[i]);
+			continue;
+		}
 		if (req_nodes_bitmap &&
 		    bit_overlap_any(req_nodes_bitmap, switch_node_bitmap[i])) {
 			switch_required[i] = 1;
@@ -2315,7 +2324,7 @@ static int _eval_nodes_topo(job_record_t *job_ptr,
 	 * top level switch.
 	 */
 	for (i = 0; i < switch_record_cnt; i++) {
-		if (top_switch_inx != i) {
+		if ((top_switch_inx != i) && switch_node_bitmap[i]) {
 			  bit_and(switch_node_bitmap[i],
 				  switch_node_bitmap[top_switch_inx]);
 		}
@@ -2454,7 +2463,7 @@ static int _eval_nodes_topo(job_record_t *job_ptr,
 
 		for (i = 0, switch_ptr = switch_record_table;
 		     i < switch_record_cnt; i++, switch_ptr++) {
-			if (switch_required[i])
+			if (switch_required[i] || !switch_node_bitmap[i])
 				continue;
 			if (bit_overlap_any(req2_nodes_bitmap,
 					    switch_node_bitmap[i])) {
@@ -2492,9 +2501,15 @@ static int _eval_nodes_topo(job_record_t *job_ptr,
 	avail_nodes_bitmap = bit_alloc(node_record_count);
 	for (i = 0, switch_ptr = switch_record_table; i < switch_record_cnt;
 	     i++, switch_ptr++) {
+		if (!switch_node_bitmap[i])
+			continue;
 		bit_and(switch_node_bitmap[i], best_nodes_bitmap);
-		bit_or(avail_nodes_bitmap, switch_node_bitmap[i]);
 		switch_node_cnt[i] = bit_set_count(switch_node_bitmap[i]);
+		if (switch_node_cnt[i] == 0) {
+			FREE_NULL_BITMAP(switch_node_bitmap[i]);
+			continue;
+		}
+		bit_or(avail_nodes_bitmap, switch_node_bitmap[i]);
 	}
 
 	if (select_debug_flags & DEBUG_FLAG_SELECT_TYPE) {
@@ -2514,14 +2529,16 @@ static int _eval_nodes_topo(job_record_t *job_ptr,
 		}
 	}
 
-	/* Count up leaf switches. */
+	/*
+	 * Count up leaf switches. Each switch_node_bitmap is now a subset of
+	 * best_nodes_bitmap, so any node left on it is an overlap.
+	 */
 	if (!req_nodes_bitmap) {
 		for (i = 0, switch_ptr = switch_record_table;
 		     i < switch_record_cnt; i++, switch_ptr++) {
 			if (switch_record_table[i].level != 0)
 				continue;
-			if (bit_overlap_any(switch_node_bitmap[i],
-					    best_nodes_bitmap))
+			if (switch_node_cnt[i])
 				leaf_switch_count++;
 		}
 	}
@@ -68,6 +68,7 @@
 #include "src/common/slurm_topology.h"
 #include "src/common/slurm_resource_info.h"
 #include "src/common/xassert.h"
+#include "src/common/xhash.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
@@ -144,6 +145,8 @@ static int  _find_job_mate(job_record_t *job_ptr, bitstr_t *bitmap,
 			   uint32_t req_nodes);
 static void _free_cr(struct cr_record *cr_ptr);
 static int _get_avail_cpus(job_record_t *job_ptr, int index);
+static void _get_switch_cpus(job_record_t *job_ptr,
+			     bitstr_t **switches_bitmap, int *switches_cpu_cnt);
 static uint16_t _get_total_cpus(int index);
 static void _init_node_cr(void);
 static int _job_count_bitmap(struct cr_record *cr_ptr,
@@ -435,6 +438,38 @@ static int _get_avail_cpus(job_record_t *job_ptr, int index)
 	return(avail_cpus);
 }
 
+/*
+ * Sum the available CPUs of the nodes on each switch. Walking each switch's
+ * own nodes touches every node once per switch level instead of testing
+ * every node against every switch, and _get_avail_cpus() is only evaluated
+ * once per node.
+ */
+static void _get_switch_cpus(job_record_t *job_ptr,
+			     bitstr_t **switches_bitmap, int *switches_cpu_cnt)
+{
+	int *node_cpus = xcalloc(node_record_count, sizeof(int));
+	bitstr_t *node_done = bit_alloc(node_record_count);
+	int i, j, first, last;
+
+	for (j = 0; j < switch_record_cnt; j++) {
+		first = bit_ffs(switches_bitmap[j]);
+		if (first < 0)
+			continue;
+		last = bit_fls(switches_bitmap[j]);
+		for (i = first; i <= last; i++) {
+			if (!bit_test(switches_bitmap[j], i))
+				continue;
+			if (!bit_test(node_done, i)) {
+				node_cpus[i] = _get_avail_cpus(job_ptr, i);
+				bit_set(node_done, i);
+			}
+			switches_cpu_cnt[j] += node_cpus[i];
+		}
+	}
+	FREE_NULL_BITMAP(node_done);
+	xfree(node_cpus);
+}
+
 /*
  * _get_total_cpus - Get the total number of cpus on a node
  *	Note that the value of cpus is the lowest-level logical
@@ -1707,14 +1742,7 @@ static int _job_test_dfly(job_record_t *job_ptr, bitstr_t *bitmap,
 	}
 
 	/* phase 2: calculate CPU resources for each switch */
-	for (i = 0; i < node_record_count; i++) {
-		avail_cpus = _get_avail_cpus(job_ptr, i);
-		for (j = 0; j < switch_record_cnt; j++) {
-			if (bit_test(switches_bitmap[j], i)) {
-				switches_cpu_cnt[j] += avail_cpus;
-			}
-		}
-	}
+	_get_switch_cpus(job_ptr, switches_bitmap, switches_cpu_cnt);
 
 	/* phase 3 */
 	/* Determine lowest level switch satisfying request with best fit */
@@ -2000,14 +2028,7 @@ static int _job_test_topo(job_record_t *job_ptr, bitstr_t *bitmap,
 	}
 
 	/* phase 2: accumulate all cpu resources for each switch */
-	for (i = 0; i < node_record_count; i++) {
-		avail_cpus = _get_avail_cpus(job_ptr, i);
-		for (j=0; j<switch_record_cnt; j++) {
-			if (bit_test(switches_bitmap[j], i)) {
-				switches_cpu_cnt[j] += avail_cpus;
-			}
-		}
-	}
+	_get_switch_cpus(job_ptr, switches_bitmap, switches_cpu_cnt);
 
 	/* phase 3 */
 	/* Determine lowest level switch satisfying request with best fit */
@@ -3092,19 +3113,43 @@ static void _init_node_cr(void)
 	_dump_node_cr(cr_ptr);
 }
 
-static int _find_job (void *x, void *key)
+/* Fetch key from xhash_t item. Called from function ptr */
+static void _job_id_key(void *item, const char **key, uint32_t *key_len)
 {
-	job_record_t *job_ptr = (job_record_t *) x;
-	if (job_ptr == (job_record_t *) key)
-		return 1;
-	return 0;
+	job_record_t *job_ptr = (job_record_t *) item;
+
+	*key = (char *) &job_ptr->job_id;
+	*key_len = sizeof(job_ptr->job_id);
 }
 
-static bool _is_preemptable(job_record_t *job_ptr, List preemptee_candidates)
+/*
+ * Index the preemption candidates by job id so that testing every running
+ * job against them is not quadratic. Caller must xhash_free() the result.
+ */
+static xhash_t *_build_preemptee_hash(List preemptee_candidates)
 {
+	xhash_t *preemptee_hash;
+	ListIterator iter;
+	job_record_t *job_ptr;
+
 	if (!preemptee_candidates)
+		return NULL;
+
+	preemptee_hash = xhash_init(_job_id_key, NULL);
+	iter = list_iterator_create(preemptee_candidates);
+	while ((job_ptr = list_next(iter)))
+		xhash_add(preemptee_hash, job_ptr);
+	list_iterator_destroy(iter);
+
+	return preemptee_hash;
+}
+
+static bool _is_preemptable(job_record_t *job_ptr, xhash_t *preemptee_hash)
+{
+	if (!preemptee_hash)
 		return false;
-	if (list_find_first(preemptee_candidates, _find_job, job_ptr))
+	if (xhash_get(preemptee_hash, (char *) &job_ptr->job_id,
+		      sizeof(job_ptr->job_id)) == job_ptr)
 		return true;
 	return false;
 }
@@ -3306,6 +3351,7 @@ static int _will_run_test(job_record_t *job_ptr, bitstr_t *bitmap,
 	job_record_t *tmp_job_ptr;
 	List cr_job_list;
 	ListIterator job_iterator, preemptee_iterator;
+	xhash_t *preemptee_hash;
 	bitstr_t *orig_map;
 	int i, max_run_jobs, rc = SLURM_ERROR;
 	time_t now = time(NULL);
@@ -3337,6 +3383,7 @@ static int _will_run_test(job_record_t *job_ptr, bitstr_t *bitmap,
 
 	/* Build list of running and suspended jobs */
 	cr_job_list = list_create(NULL);
+	preemptee_hash = _build_preemptee_hash(preemptee_candidates);
 	job_iterator = list_iterator_create(job_list);
 	while ((tmp_job_ptr = list_next(job_iterator))) {
 		if (!IS_JOB_RUNNING(tmp_job_ptr) &&
@@ -3352,7 +3399,7 @@ static int _will_run_test(job_record_t *job_ptr, bitstr_t *bitmap,
 			      __func__, tmp_job_ptr);
 			continue;
 		}
-		if (!_is_preemptable(tmp_job_ptr, preemptee_candidates)) {
+		if (!_is_preemptable(tmp_job_ptr, preemptee_hash)) {
 			/* Queue job for later removal from data structures */
 			list_append(cr_job_list, tmp_job_ptr);
 		} else {
@@ -3367,6 +3414,7 @@ static int _will_run_test(job_record_t *job_ptr, bitstr_t *bitmap,
 		}
 	}
 	list_iterator_destroy(job_iterator);
+	xhash_free(preemptee_hash);
 
 	/* Test with all preemptable jobs gone */
 	if (preemptee_candidates) {
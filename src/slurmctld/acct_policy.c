@@ -40,6 +40,7 @@
 
 #include "src/common/assoc_mgr.h"
 #include "src/common/slurm_accounting_storage.h"
+#include "src/common/xhash.h"
 
 #include "src/slurmctld/slurmctld.h"
 #include "src/slurmctld/acct_policy.h"
@@ -48,6 +49,26 @@
 
 #define _DEBUG 0
 
+/*
+ * Indexes of the QOS used limits lists, kept here rather than in the public
+ * slurmdb_qos_usage_t. Entries are keyed by the usage pointer, so all of them
+ * are dropped once g_qos_usage_gen shows a usage may have been freed.
+ */
+typedef struct {
+	xhash_t *acct_hash;	/* acct_limit_list indexed by account */
+	slurmdb_qos_usage_t *usage;
+	xhash_t *user_hash;	/* user_limit_list indexed by uid */
+} used_limits_index_t;
+
+static xhash_t *used_limits_index = NULL;
+static uint32_t used_limits_index_gen = 0; /* g_qos_usage_gen of the index */
+
+/*
+ * Serializes additions to the QOS used limits lists and their indexes,
+ * which happen with only a read lock on the QOS.
+ */
+static pthread_mutex_t used_limits_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 enum {
 	ACCT_POLICY_ADD_SUBMIT,
 	ACCT_POLICY_REM_SUBMIT,
@@ -537,17 +558,6 @@ static int _find_used_limits_for_acct(void *x, void *key)
 	return 0;
 }
 
-static int _find_used_limits_for_user(void *x, void *key)
-{
-	slurmdb_used_limits_t *used_limits = (slurmdb_used_limits_t *)x;
-	uint32_t user_id = *(uint32_t *)key;
-
-	if (used_limits->uid == user_id)
-		return 1;
-
-	return 0;
-}
-
 static bool _valid_job_assoc(job_record_t *job_ptr)
 {
 	slurmdb_assoc_rec_t assoc_rec;
@@ -587,11 +597,11 @@ static void _qos_adjust_limit_usage(int type, job_record_t *job_ptr,
 		return;
 
 	used_limits_a =	acct_policy_get_acct_used_limits(
-		&qos_ptr->usage->acct_limit_list,
+		qos_ptr->usage,
 		job_ptr->assoc_ptr->acct);
 
 	used_limits = acct_policy_get_user_used_limits(
-		&qos_ptr->usage->user_limit_list,
+		qos_ptr->usage,
 		job_ptr->user_id);
 
 	switch (type) {
@@ -1811,7 +1821,7 @@ static int _qos_policy_validate(job_desc_msg_t *job_desc,
 	    (qos_ptr->max_submit_jobs_pa != INFINITE)) {
 		slurmdb_used_limits_t *used_limits =
 			acct_policy_get_acct_used_limits(
-				&qos_ptr->usage->acct_limit_list,
+				qos_ptr->usage,
 				assoc_ptr->acct);
 
 		qos_out_ptr->max_submit_jobs_pa = qos_ptr->max_submit_jobs_pa;
@@ -1834,7 +1844,7 @@ static int _qos_policy_validate(job_desc_msg_t *job_desc,
 	    (qos_ptr->max_submit_jobs_pu != INFINITE)) {
 		slurmdb_used_limits_t *used_limits =
 			acct_policy_get_user_used_limits(
-				&qos_ptr->usage->user_limit_list,
+				qos_ptr->usage,
 				job_desc->user_id);
 
 		qos_out_ptr->max_submit_jobs_pu = qos_ptr->max_submit_jobs_pu;
@@ -1908,11 +1918,11 @@ static int _qos_job_runnable_pre_select(job_record_t *job_ptr,
 	wall_mins = qos_ptr->usage->grp_used_wall / 60;
 
 	used_limits_a =	acct_policy_get_acct_used_limits(
-		&qos_ptr->usage->acct_limit_list,
+		qos_ptr->usage,
 		assoc_ptr->acct);
 
 	used_limits = acct_policy_get_user_used_limits(
-		&qos_ptr->usage->user_limit_list,
+		qos_ptr->usage,
 		job_ptr->user_id);
 
 
@@ -2132,11 +2142,11 @@ static int _qos_job_runnable_post_select(job_record_t *job_ptr,
 	}
 
 	used_limits_a =	acct_policy_get_acct_used_limits(
-		&qos_ptr->usage->acct_limit_list,
+		qos_ptr->usage,
 		assoc_ptr->acct);
 
 	used_limits = acct_policy_get_user_used_limits(
-		&qos_ptr->usage->user_limit_list,
+		qos_ptr->usage,
 		job_ptr->user_id);
 
 	tres_usage = _validate_tres_usage_limits_for_qos(
@@ -4425,19 +4435,19 @@ extern int acct_policy_handle_accrue_time(job_record_t *job_ptr,
 
 	if (qos_ptr_1) {
 		used_limits_a1 = acct_policy_get_acct_used_limits(
-			&qos_ptr_1->usage->acct_limit_list,
+			qos_ptr_1->usage,
 			assoc_ptr->acct);
 		used_limits_u1 = acct_policy_get_user_used_limits(
-				&qos_ptr_1->usage->user_limit_list,
+				qos_ptr_1->usage,
 				job_ptr->user_id);
 	}
 
 	if (qos_ptr_2) {
 		used_limits_a2 = acct_policy_get_acct_used_limits(
-			&qos_ptr_2->usage->acct_limit_list,
+			qos_ptr_2->usage,
 			assoc_ptr->acct);
 		used_limits_u2 = acct_policy_get_user_used_limits(
-				&qos_ptr_2->usage->user_limit_list,
+				qos_ptr_2->usage,
 				job_ptr->user_id);
 	}
 
@@ -4668,19 +4678,19 @@ extern void acct_policy_add_accrue_time(job_record_t *job_ptr,
 
 	if (qos_ptr_1) {
 		used_limits_a1 = acct_policy_get_acct_used_limits(
-			&qos_ptr_1->usage->acct_limit_list,
+			qos_ptr_1->usage,
 			assoc_ptr->acct);
 		used_limits_u1 = acct_policy_get_user_used_limits(
-				&qos_ptr_1->usage->user_limit_list,
+				qos_ptr_1->usage,
 				job_ptr->user_id);
 	}
 
 	if (qos_ptr_2) {
 		used_limits_a2 = acct_policy_get_acct_used_limits(
-			&qos_ptr_2->usage->acct_limit_list,
+			qos_ptr_2->usage,
 			assoc_ptr->acct);
 		used_limits_u2 = acct_policy_get_user_used_limits(
-				&qos_ptr_2->usage->user_limit_list,
+				qos_ptr_2->usage,
 				job_ptr->user_id);
 	}
 
@@ -4740,19 +4750,19 @@ extern void acct_policy_remove_accrue_time(job_record_t *job_ptr,
 
 	if (qos_ptr_1) {
 		used_limits_a1 = acct_policy_get_acct_used_limits(
-			&qos_ptr_1->usage->acct_limit_list,
+			qos_ptr_1->usage,
 			assoc_ptr->acct);
 		used_limits_u1 = acct_policy_get_user_used_limits(
-				&qos_ptr_1->usage->user_limit_list,
+				qos_ptr_1->usage,
 				job_ptr->user_id);
 	}
 
 	if (qos_ptr_2) {
 		used_limits_a2 = acct_policy_get_acct_used_limits(
-			&qos_ptr_2->usage->acct_limit_list,
+			qos_ptr_2->usage,
 			assoc_ptr->acct);
 		used_limits_u2 = acct_policy_get_user_used_limits(
-				&qos_ptr_2->usage->user_limit_list,
+				qos_ptr_2->usage,
 				job_ptr->user_id);
 	}
 
@@ -4900,25 +4910,133 @@ extern void acct_policy_set_qos_order(job_record_t *job_ptr,
 	return;
 }
 
+/* Fetch key from xhash_t item. Called from function ptr */
+static void _used_limits_acct_id(void *item, const char **key,
+				 uint32_t *key_len)
+{
+	slurmdb_used_limits_t *used_limits = (slurmdb_used_limits_t *) item;
+
+	*key = used_limits->acct;
+	*key_len = strlen(used_limits->acct) + 1;	/* Non-zero, even for "" */
+}
+
+/* Fetch key from xhash_t item. Called from function ptr */
+static void _used_limits_user_id(void *item, const char **key,
+				 uint32_t *key_len)
+{
+	slurmdb_used_limits_t *used_limits = (slurmdb_used_limits_t *) item;
+
+	*key = (char *) &used_limits->uid;
+	*key_len = sizeof(used_limits->uid);
+}
+
+/* Fetch key from xhash_t item. Called from function ptr */
+static void _used_limits_index_id(void *item, const char **key,
+				  uint32_t *key_len)
+{
+	used_limits_index_t *index = (used_limits_index_t *) item;
+
+	*key = (char *) &index->usage;
+	*key_len = sizeof(index->usage);
+}
+
+static void _used_limits_index_free(void *item)
+{
+	used_limits_index_t *index = (used_limits_index_t *) item;
+
+	if (index) {
+		xhash_free(index->acct_hash);
+		xhash_free(index->user_hash);
+		xfree(index);
+	}
+}
+
+/*
+ * Get the index entry of usage, creating it if needed.
+ * QOS read lock must be held so g_qos_usage_gen is stable.
+ */
+static used_limits_index_t *_used_limits_index(slurmdb_qos_usage_t *usage)
+{
+	used_limits_index_t *index;
+
+	if (used_limits_index && (used_limits_index_gen != g_qos_usage_gen))
+		xhash_free(used_limits_index);
+
+	if (!used_limits_index) {
+		used_limits_index = xhash_init(_used_limits_index_id,
+					       _used_limits_index_free);
+		used_limits_index_gen = g_qos_usage_gen;
+	} else if ((index = xhash_get(used_limits_index, (char *) &usage,
+				      sizeof(usage))))
+		return index;
+
+	index = xmalloc(sizeof(used_limits_index_t));
+	index->usage = usage;
+	xhash_add(used_limits_index, index);
+
+	return index;
+}
+
+/*
+ * Index an existing used limits list (e.g. one restored from the assoc_mgr
+ * state file) the first time it is searched.
+ */
+static xhash_t *_used_limits_hash(xhash_t **hash_ptr, List limit_list,
+				  xhash_idfunc_t idfunc)
+{
+	slurmdb_used_limits_t *used_limits;
+	ListIterator itr;
+
+	if (*hash_ptr)
+		return *hash_ptr;
+
+	*hash_ptr = xhash_init(idfunc, NULL);
+	itr = list_iterator_create(limit_list);
+	while ((used_limits = list_next(itr))) {
+		if ((idfunc == _used_limits_acct_id) && !used_limits->acct)
+			continue;
+		xhash_add(*hash_ptr, used_limits);
+	}
+	list_iterator_destroy(itr);
+
+	return *hash_ptr;
+}
+
 /*
- * Checks for record in *user_limit_list of user_id if
- * *user_limit_list doesn't exist it will create it, if the user_id
+ * Checks for record in usage->acct_limit_list of acct, if
+ * acct_limit_list doesn't exist it will create it, if the acct
  * record doesn't exist it will add it to the list.
- * In all cases the user record is returned.
+ * In all cases the acct record is returned.
+ * NOTE: Records are found through an index rather than by walking the
+ * list, a QOS can have records for thousands of accounts.
  */
 extern slurmdb_used_limits_t *acct_policy_get_acct_used_limits(
-	List *acct_limit_list, char *acct)
+	slurmdb_qos_usage_t *usage, char *acct)
 {
 	slurmdb_used_limits_t *used_limits;
+	xhash_t *hash;
 
-	xassert(acct_limit_list);
+	xassert(usage);
 
-	if (!*acct_limit_list)
-		*acct_limit_list = list_create(slurmdb_destroy_used_limits);
+	slurm_mutex_lock(&used_limits_mutex);
+	if (!usage->acct_limit_list)
+		usage->acct_limit_list =
+			list_create(slurmdb_destroy_used_limits);
 
-	if (!(used_limits = list_find_first(*acct_limit_list,
-					    _find_used_limits_for_acct,
-					    acct))) {
+	if (!acct) {
+		used_limits = list_find_first(usage->acct_limit_list,
+					      _find_used_limits_for_acct, acct);
+		hash = NULL;
+	} else {
+		used_limits_index_t *index = _used_limits_index(usage);
+
+		hash = _used_limits_hash(&index->acct_hash,
+					 usage->acct_limit_list,
+					 _used_limits_acct_id);
+		used_limits = xhash_get(hash, acct, strlen(acct) + 1);
+	}
+
+	if (!used_limits) {
 		int i = sizeof(uint64_t) * slurmctld_tres_cnt;
 
 		used_limits = xmalloc(sizeof(slurmdb_used_limits_t));
@@ -4927,31 +5045,42 @@ extern slurmdb_used_limits_t *acct_policy_get_acct_used_limits(
 		used_limits->tres = xmalloc(i);
 		used_limits->tres_run_mins = xmalloc(i);
 
-		list_append(*acct_limit_list, used_limits);
+		list_append(usage->acct_limit_list, used_limits);
+		if (hash)
+			xhash_add(hash, used_limits);
 	}
+	slurm_mutex_unlock(&used_limits_mutex);
 
 	return used_limits;
 }
 
 /*
- * Checks for record in *user_limit_list of user_id if
- * *user_limit_list doesn't exist it will create it, if the user_id
+ * Checks for record in usage->user_limit_list of user_id if
+ * user_limit_list doesn't exist it will create it, if the user_id
  * record doesn't exist it will add it to the list.
  * In all cases the user record is returned.
+ * NOTE: Records are found through an index rather than by walking the
+ * list, a QOS can have records for thousands of users.
  */
 extern slurmdb_used_limits_t *acct_policy_get_user_used_limits(
-	List *user_limit_list, uint32_t user_id)
+	slurmdb_qos_usage_t *usage, uint32_t user_id)
 {
 	slurmdb_used_limits_t *used_limits;
+	used_limits_index_t *index;
+	xhash_t *hash;
 
-	xassert(user_limit_list);
+	xassert(usage);
 
-	if (!*user_limit_list)
-		*user_limit_list = list_create(slurmdb_destroy_used_limits);
+	slurm_mutex_lock(&used_limits_mutex);
+	if (!usage->user_limit_list)
+		usage->user_limit_list =
+			list_create(slurmdb_destroy_used_limits);
 
-	if (!(used_limits = list_find_first(*user_limit_list,
-					    _find_used_limits_for_user,
-					    &user_id))) {
+	index = _used_limits_index(usage);
+	hash = _used_limits_hash(&index->user_hash, usage->user_limit_list,
+				 _used_limits_user_id);
+	if (!(used_limits = xhash_get(hash, (char *) &user_id,
+				      sizeof(user_id)))) {
 		int i = sizeof(uint64_t) * slurmctld_tres_cnt;
 
 		used_limits = xmalloc(sizeof(slurmdb_used_limits_t));
@@ -4960,8 +5089,18 @@ extern slurmdb_used_limits_t *acct_policy_get_user_used_limits(
 		used_limits->tres = xmalloc(i);
 		used_limits->tres_run_mins = xmalloc(i);
 
-		list_append(*user_limit_list, used_limits);
+		list_append(usage->user_limit_list, used_limits);
+		xhash_add(hash, used_limits);
 	}
+	slurm_mutex_unlock(&used_limits_mutex);
 
 	return used_limits;
 }
+
+/* Free the used limits indexes, e.g. on shutdown */
+extern void acct_policy_free_used_limits(void)
+{
+	slurm_mutex_lock(&used_limits_mutex);
+	xhash_free(used_limits_index);
+	slurm_mutex_unlock(&used_limits_mutex);
+}
@@ -870,6 +870,7 @@ int main(int argc, char **argv)
 	purge_front_end_state();
 	resv_fini();
 	trigger_fini();
+	acct_policy_free_used_limits();
 	assoc_mgr_fini(1);
 	reserve_port_config(NULL);
 	free_rpc_stats();
@@ -89,6 +89,7 @@ struct gs_job {
 	job_record_t *job_ptr;
 	uint16_t sig_state;
 	uint16_t row_state;
+	bool shadow_cast;	/* job is in some partition's shadow array */
 };
 
 struct gs_part {
@@ -397,7 +398,6 @@ static int _job_fits_in_active_row(job_record_t *job_ptr,
 {
 	job_resources_t *job_res = job_ptr->job_resrcs;
 	int count;
-	bitstr_t *job_map;
 	uint16_t job_gr_type;
 
 	if ((p_ptr->active_resmap == NULL) || (p_ptr->jobs_active == 0))
@@ -411,13 +411,10 @@ static int _job_fits_in_active_row(job_record_t *job_ptr,
 	}
 
 	/* job_gr_type == GS_NODE || job_gr_type == GS_CPU */
-	job_map = bit_copy(job_res->node_bitmap);
-	bit_and(job_map, p_ptr->active_resmap);
-	/* any set bits indicate contention for the same resource */
-	count = bit_set_count(job_map);
+	/* any common bits indicate contention for the same resource */
+	count = bit_overlap(job_res->node_bitmap, p_ptr->active_resmap);
 	if (slurmctld_conf.debug_flags & DEBUG_FLAG_GANG)
 		info("gang: _job_fits_in_active_row: %d bits conflict", count);
-	FREE_NULL_BITMAP(job_map);
 	if (count == 0)
 		return 1;
 	if (job_gr_type == GS_CPU) {
@@ -684,7 +681,14 @@ static void _cast_shadow(struct gs_job *j_ptr, uint16_t priority)
 {
 	ListIterator part_iterator;
 	struct gs_part *p_ptr;
-	int i;
+
+	/*
+	 * Shadows are only ever cast on and cleared from every lower priority
+	 * partition at once, so there is nothing to do if this job already
+	 * casts one.
+	 */
+	if (j_ptr->shadow_cast)
+		return;
 
 	part_iterator = list_iterator_create(gs_part_list);
 	while ((p_ptr = list_next(part_iterator))) {
@@ -698,14 +702,6 @@ static void _cast_shadow(struct gs_job *j_ptr, uint16_t priority)
 			p_ptr->shadow = xmalloc(p_ptr->shadow_size *
 						sizeof(struct gs_job *));
 			/* 'shadow' is initialized to be NULL filled */
-		} else {
-			/* does this shadow already exist? */
-			for (i = 0; i < p_ptr->num_shadows; i++) {
-				if (p_ptr->shadow[i] == j_ptr)
-					break;
-			}
-			if (i < p_ptr->num_shadows)
-				continue;
 		}
 
 		if (p_ptr->num_shadows+1 >= p_ptr->shadow_size) {
@@ -714,6 +710,7 @@ static void _cast_shadow(struct gs_job *j_ptr, uint16_t priority)
 						sizeof(struct gs_job *));
 		}
 		p_ptr->shadow[p_ptr->num_shadows++] = j_ptr;
+		j_ptr->shadow_cast = true;
 	}
 	list_iterator_destroy(part_iterator);
 }
@@ -726,6 +723,10 @@ static void _clear_shadow(struct gs_job *j_ptr)
 	struct gs_part *p_ptr;
 	int i;
 
+	if (!j_ptr->shadow_cast)
+		return;
+	j_ptr->shadow_cast = false;
+
 	part_iterator = list_iterator_create(gs_part_list);
 	while ((p_ptr = list_next(part_iterator))) {
 		if (!p_ptr->shadow)
@@ -1455,27 +1456,32 @@ static void _build_active_row(struct gs_part *p_ptr)
  */
 static void _cycle_job_list(struct gs_part *p_ptr)
 {
-	int i, j;
-	struct gs_job *j_ptr;
+	int i, j, k;
+	struct gs_job *j_ptr, **active_list;
 	uint16_t preempt_mode;
 
 	if (slurmctld_conf.debug_flags & DEBUG_FLAG_GANG)
 		info("gang: entering %s", __func__);
-	/* re-prioritize the job_list and set all row_states to GS_NO_ACTIVE */
-	for (i = 0; i < p_ptr->num_jobs; i++) {
-		while (p_ptr->job_list[i]->row_state == GS_ACTIVE) {
-			/* move this job to the back row and "deactivate" it */
-			j_ptr = p_ptr->job_list[i];
+	/*
+	 * re-prioritize the job_list and set all row_states to GS_NO_ACTIVE:
+	 * move the active jobs to the back row, preserving the order of the
+	 * jobs within each group, in a single pass over the job_list
+	 */
+	active_list = xcalloc(p_ptr->num_jobs + 1, sizeof(struct gs_job *));
+	for (i = 0, j = 0, k = 0; i < p_ptr->num_jobs; i++) {
+		j_ptr = p_ptr->job_list[i];
+		if (j_ptr->row_state == GS_ACTIVE) {
+			/* "deactivate" it */
 			j_ptr->row_state = GS_NO_ACTIVE;
-			for (j = i; j+1 < p_ptr->num_jobs; j++) {
-				p_ptr->job_list[j] = p_ptr->job_list[j+1];
-			}
-			p_ptr->job_list[j] = j_ptr;
+			active_list[k++] = j_ptr;
+			continue;
 		}
-		if (p_ptr->job_list[i]->row_state == GS_FILLER)
-			p_ptr->job_list[i]->row_state = GS_NO_ACTIVE;
-
+		if (j_ptr->row_state == GS_FILLER)
+			j_ptr->row_state = GS_NO_ACTIVE;
+		p_ptr->job_list[j++] = j_ptr;
 	}
+	memcpy(p_ptr->job_list + j, active_list, k * sizeof(struct gs_job *));
+	xfree(active_list);
 	if (slurmctld_conf.debug_flags & DEBUG_FLAG_GANG)
 		info("gang: %s reordered job list:", __func__);
 	/* Rebuild the active row. */
@@ -83,6 +83,7 @@
 #include "src/common/tres_bind.h"
 #include "src/common/tres_frequency.h"
 #include "src/common/xassert.h"
+#include "src/common/xhash.h"
 #include "src/common/xstring.h"
 
 #include "src/slurmctld/acct_policy.h"
@@ -134,6 +135,15 @@ typedef struct {
 	bitstr_t **resp_array_task_id;
 } resp_array_struct_t;
 
+/*
+ * Reference counted string shared by job records, see _job_str_get().
+ * Protected by the job write lock.
+ */
+typedef struct {
+	char     *str;
+	uint32_t  ref_cnt;
+} job_str_t;
+
 typedef struct {
 	Buf       buffer;
 	uint32_t  filter_uid;
@@ -160,6 +170,7 @@ static uint32_t job_id_sequence = 0;	/* first job_id to assign new job */
 static struct   job_record **job_hash = NULL;
 static struct   job_record **job_array_hash_j = NULL;
 static struct   job_record **job_array_hash_t = NULL;
+static xhash_t *job_str_hash = NULL;
 static bool     kill_invalid_dep;
 static time_t   last_file_write_time = (time_t) 0;
 static uint32_t max_array_size = NO_VAL;
@@ -180,6 +191,9 @@ static int  _copy_job_desc_to_job_record(job_desc_msg_t * job_desc,
 static char *_copy_nodelist_no_dup(char *node_list);
 static job_record_t *_create_job_record(uint32_t num_jobs);
 static void _delete_job_details(job_record_t *job_entry);
+static char *_job_str_get(const char *str);
+static void _job_str_put(char **str);
+static void _job_str_array_share(char **array, uint32_t cnt);
 static void _del_batch_list_rec(void *x);
 static slurmdb_qos_rec_t *_determine_and_validate_qos(
 	char *resv_name, slurmdb_assoc_rec_t *assoc_ptr,
@@ -608,6 +622,84 @@ static job_record_t *_create_job_record(uint32_t num_jobs)
 }
 
 
+/* Fetch key from xhash_t item. Called from function ptr */
+static void _job_str_id(void *item, const char **key, uint32_t *key_len)
+{
+	job_str_t *job_str = (job_str_t *) item;
+
+	*key = job_str->str;
+	*key_len = strlen(job_str->str) + 1;	/* Non-zero, even for "" */
+}
+
+/*
+ * _job_str_get - return a shared copy of a string for a job record
+ *
+ * The working directory, I/O path templates, arguments and binding options
+ * of a job are normally the same for every task of a job array and for jobs
+ * submitted from the same script, so job records share a single reference
+ * counted copy of them.
+ * The returned string must not be modified or xfree()d, release it with
+ * _job_str_put() instead.
+ * IN str - string to share, may be NULL
+ * RET shared copy of str or NULL
+ */
+static char *_job_str_get(const char *str)
+{
+	job_str_t *job_str;
+
+	if (!str)
+		return NULL;
+
+	if (!job_str_hash)
+		job_str_hash = xhash_init(_job_str_id, NULL);
+	else if ((job_str = xhash_get(job_str_hash, str, strlen(str) + 1))) {
+		job_str->ref_cnt++;
+		return job_str->str;
+	}
+
+	job_str = xmalloc(sizeof(job_str_t));
+	job_str->str = xstrdup(str);
+	job_str->ref_cnt = 1;
+	xhash_add(job_str_hash, job_str);
+
+	return job_str->str;
+}
+
+/*
+ * _job_str_put - release a string returned by _job_str_get() and clear
+ *	the pointer to it
+ */
+static void _job_str_put(char **str)
+{
+	job_str_t *job_str;
+
+	if (!*str)
+		return;
+
+	job_str = xhash_get(job_str_hash, *str, strlen(*str) + 1);
+	xassert(job_str && (job_str->str == *str));
+	if (job_str && (--job_str->ref_cnt == 0)) {
+		xhash_delete(job_str_hash, job_str->str,
+			     strlen(job_str->str) + 1);
+		xfree(job_str->str);
+		xfree(job_str);
+	}
+	*str = NULL;
+}
+
+/* Replace the xmalloc()ed strings of an array with shared copies */
+static void _job_str_array_share(char **array, uint32_t cnt)
+{
+	char *tmp;
+	int i;
+
+	for (i = 0; i < cnt; i++) {
+		tmp = array[i];
+		array[i] = _job_str_get(tmp);
+		xfree(tmp);
+	}
+}
+
 /*
  * _delete_job_details - delete a job's detail record and clear it's pointer
  * IN job_entry - pointer to job_record to clear the record of
@@ -632,31 +724,31 @@ static void _delete_job_details(job_record_t *job_entry)
 		list_enqueue(purge_files_list, job_id);
 	}
 
-	xfree(job_entry->details->acctg_freq);
+	_job_str_put(&job_entry->details->acctg_freq);
 	for (i=0; i<job_entry->details->argc; i++)
-		xfree(job_entry->details->argv[i]);
+		_job_str_put(&job_entry->details->argv[i]);
 	xfree(job_entry->details->argv);
-	xfree(job_entry->details->cpu_bind);
+	_job_str_put(&job_entry->details->cpu_bind);
 	FREE_NULL_LIST(job_entry->details->depend_list);
 	xfree(job_entry->details->dependency);
 	xfree(job_entry->details->orig_dependency);
 	for (i=0; i<job_entry->details->env_cnt; i++)
 		xfree(job_entry->details->env_sup[i]);
 	xfree(job_entry->details->env_sup);
-	xfree(job_entry->details->std_err);
+	_job_str_put(&job_entry->details->std_err);
 	FREE_NULL_BITMAP(job_entry->details->exc_node_bitmap);
 	xfree(job_entry->details->exc_nodes);
 	xfree(job_entry->details->extra);
 	FREE_NULL_LIST(job_entry->details->feature_list);
 	xfree(job_entry->details->features);
 	xfree(job_entry->details->cluster_features);
-	xfree(job_entry->details->std_in);
+	_job_str_put(&job_entry->details->std_in);
 	xfree(job_entry->details->mc_ptr);
-	xfree(job_entry->details->mem_bind);
-	xfree(job_entry->details->std_out);
+	_job_str_put(&job_entry->details->mem_bind);
+	_job_str_put(&job_entry->details->std_out);
 	FREE_NULL_BITMAP(job_entry->details->req_node_bitmap);
 	xfree(job_entry->details->req_nodes);
-	xfree(job_entry->details->work_dir);
+	_job_str_put(&job_entry->details->work_dir);
 	xfree(job_entry->details->x11_magic_cookie);
 	xfree(job_entry->details->x11_target);
 	xfree(job_entry->details);	/* Must be last */
@@ -2794,35 +2886,38 @@ static int _load_job_details(job_record_t *job_ptr, Buf buffer,
 	}
 
 	/* free any left-over detail data */
-	xfree(job_ptr->details->acctg_freq);
+	_job_str_put(&job_ptr->details->acctg_freq);
 	for (i=0; i<job_ptr->details->argc; i++)
-		xfree(job_ptr->details->argv[i]);
+		_job_str_put(&job_ptr->details->argv[i]);
 	xfree(job_ptr->details->argv);
-	xfree(job_ptr->details->cpu_bind);
+	_job_str_put(&job_ptr->details->cpu_bind);
 	xfree(job_ptr->details->dependency);
 	xfree(job_ptr->details->orig_dependency);
-	xfree(job_ptr->details->std_err);
+	_job_str_put(&job_ptr->details->std_err);
 	for (i=0; i<job_ptr->details->env_cnt; i++)
 		xfree(job_ptr->details->env_sup[i]);
 	xfree(job_ptr->details->env_sup);
 	xfree(job_ptr->details->exc_nodes);
 	xfree(job_ptr->details->features);
 	xfree(job_ptr->details->cluster_features);
-	xfree(job_ptr->details->std_in);
-	xfree(job_ptr->details->mem_bind);
-	xfree(job_ptr->details->std_out);
+	_job_str_put(&job_ptr->details->std_in);
+	_job_str_put(&job_ptr->details->mem_bind);
+	_job_str_put(&job_ptr->details->std_out);
 	xfree(job_ptr->details->req_nodes);
-	xfree(job_ptr->details->work_dir);
+	_job_str_put(&job_ptr->details->work_dir);
 
 	/* now put the details into the job record */
-	job_ptr->details->acctg_freq = acctg_freq;
+	job_ptr->details->acctg_freq = _job_str_get(acctg_freq);
+	xfree(acctg_freq);
 	job_ptr->details->argc = argc;
 	job_ptr->details->argv = argv;
+	_job_str_array_share(argv, argc);
 	job_ptr->details->accrue_time = accrue_time;
 	job_ptr->details->begin_time = begin_time;
 	job_ptr->details->contiguous = contiguous;
 	job_ptr->details->core_spec = core_spec;
-	job_ptr->details->cpu_bind = cpu_bind;
+	job_ptr->details->cpu_bind = _job_str_get(cpu_bind);
+	xfree(cpu_bind);
 	job_ptr->details->cpu_bind_type = cpu_bind_type;
 	job_ptr->details->cpu_freq_min = cpu_freq_min;
 	job_ptr->details->cpu_freq_max = cpu_freq_max;
@@ -2833,11 +2928,13 @@ static int _load_job_details(job_record_t *job_ptr, Buf buffer,
 	job_ptr->details->orig_dependency = orig_dependency;
 	job_ptr->details->env_cnt = env_cnt;
 	job_ptr->details->env_sup = env_sup;
-	job_ptr->details->std_err = err;
+	job_ptr->details->std_err = _job_str_get(err);
+	xfree(err);
 	job_ptr->details->exc_nodes = exc_nodes;
 	job_ptr->details->features = features;
 	job_ptr->details->cluster_features = cluster_features;
-	job_ptr->details->std_in = in;
+	job_ptr->details->std_in = _job_str_get(in);
+	xfree(in);
 	job_ptr->details->pn_min_cpus = pn_min_cpus;
 	job_ptr->details->orig_pn_min_cpus = pn_min_cpus;
 	job_ptr->details->pn_min_memory = pn_min_memory;
@@ -2847,7 +2944,8 @@ static int _load_job_details(job_record_t *job_ptr, Buf buffer,
 	job_ptr->details->orig_max_cpus = max_cpus;
 	job_ptr->details->max_nodes = max_nodes;
 	job_ptr->details->mc_ptr = mc_ptr;
-	job_ptr->details->mem_bind = mem_bind;
+	job_ptr->details->mem_bind = _job_str_get(mem_bind);
+	xfree(mem_bind);
 	job_ptr->details->mem_bind_type = mem_bind_type;
 	job_ptr->details->min_cpus = min_cpus;
 	job_ptr->details->orig_min_cpus = min_cpus;
@@ -2856,7 +2954,8 @@ static int _load_job_details(job_record_t *job_ptr, Buf buffer,
 	job_ptr->details->ntasks_per_node = ntasks_per_node;
 	job_ptr->details->num_tasks = num_tasks;
 	job_ptr->details->open_mode = open_mode;
-	job_ptr->details->std_out = out;
+	job_ptr->details->std_out = _job_str_get(out);
+	xfree(out);
 	job_ptr->details->overcommit = overcommit;
 	job_ptr->details->plane_size = plane_size;
 	job_ptr->details->prolog_running = prolog_running;
@@ -2866,7 +2965,8 @@ static int _load_job_details(job_record_t *job_ptr, Buf buffer,
 	job_ptr->details->submit_time = submit_time;
 	job_ptr->details->task_dist = task_dist;
 	job_ptr->details->whole_node = whole_node;
-	job_ptr->details->work_dir = work_dir;
+	job_ptr->details->work_dir = _job_str_get(work_dir);
+	xfree(work_dir);
 
 	return SLURM_SUCCESS;
 
@@ -4378,6 +4478,7 @@ extern job_record_t *job_array_split(job_record_t *job_ptr)
 	uint64_t save_db_index = job_ptr->db_index;
 	priority_factors_object_t *save_prio_factors;
 	List save_step_list;
+	xhash_t *save_step_hash;
 	int i;
 
 	job_ptr_pend = _create_job_record(0);
@@ -4402,6 +4503,7 @@ extern job_record_t *job_array_split(job_record_t *job_ptr)
 	save_details  = job_ptr_pend->details;
 	save_prio_factors = job_ptr_pend->prio_factors;
 	save_step_list = job_ptr_pend->step_list;
+	save_step_hash = job_ptr_pend->step_hash;
 	memcpy(job_ptr_pend, job_ptr, sizeof(job_record_t));
 
 	job_ptr_pend->job_id   = save_job_id;
@@ -4409,6 +4511,7 @@ extern job_record_t *job_array_split(job_record_t *job_ptr)
 	job_ptr_pend->details  = save_details;
 	job_ptr_pend->db_flags = 0;
 	job_ptr_pend->step_list = save_step_list;
+	job_ptr_pend->step_hash = save_step_hash;
 	job_ptr_pend->db_index = save_db_index;
 
 	job_ptr_pend->prio_factors = save_prio_factors;
@@ -4540,15 +4643,16 @@ extern job_record_t *job_array_split(job_record_t *job_ptr)
 	 */
 	details_new->preempt_start_time = 0;
 
-	details_new->acctg_freq = xstrdup(job_details->acctg_freq);
+	details_new->acctg_freq = _job_str_get(job_details->acctg_freq);
 	if (job_details->argc) {
 		details_new->argv =
 			xcalloc((job_details->argc + 1), sizeof(char *));
 		for (i = 0; i < job_details->argc; i++) {
-			details_new->argv[i] = xstrdup(job_details->argv[i]);
+			details_new->argv[i] =
+				_job_str_get(job_details->argv[i]);
 		}
 	}
-	details_new->cpu_bind = xstrdup(job_details->cpu_bind);
+	details_new->cpu_bind = _job_str_get(job_details->cpu_bind);
 	details_new->cpu_bind_type = job_details->cpu_bind_type;
 	details_new->cpu_freq_min = job_details->cpu_freq_min;
 	details_new->cpu_freq_max = job_details->cpu_freq_max;
@@ -4578,17 +4682,17 @@ extern job_record_t *job_array_split(job_record_t *job_ptr)
 		details_new->mc_ptr = xmalloc(i);
 		memcpy(details_new->mc_ptr, job_details->mc_ptr, i);
 	}
-	details_new->mem_bind = xstrdup(job_details->mem_bind);
+	details_new->mem_bind = _job_str_get(job_details->mem_bind);
 	details_new->mem_bind_type = job_details->mem_bind_type;
 	if (job_details->req_node_bitmap) {
 		details_new->req_node_bitmap =
 			bit_copy(job_details->req_node_bitmap);
 	}
 	details_new->req_nodes = xstrdup(job_details->req_nodes);
-	details_new->std_err = xstrdup(job_details->std_err);
-	details_new->std_in = xstrdup(job_details->std_in);
-	details_new->std_out = xstrdup(job_details->std_out);
-	details_new->work_dir = xstrdup(job_details->work_dir);
+	details_new->std_err = _job_str_get(job_details->std_err);
+	details_new->std_in = _job_str_get(job_details->std_in);
+	details_new->std_out = _job_str_get(job_details->std_out);
+	details_new->work_dir = _job_str_get(job_details->work_dir);
 	details_new->x11_magic_cookie = xstrdup(job_details->x11_magic_cookie);
 
 	if (job_ptr->fed_details)
@@ -8067,11 +8171,12 @@ static int _copy_job_desc_to_job_record(job_desc_msg_t *job_desc,
 	detail_ptr = job_ptr->details;
 	detail_ptr->argc = job_desc->argc;
 	detail_ptr->argv = job_desc->argv;
+	_job_str_array_share(detail_ptr->argv, detail_ptr->argc);
 	job_desc->argv   = (char **) NULL; /* nothing left to free */
 	job_desc->argc   = 0;		   /* nothing left to free */
-	detail_ptr->acctg_freq = xstrdup(job_desc->acctg_freq);
+	detail_ptr->acctg_freq = _job_str_get(job_desc->acctg_freq);
 	detail_ptr->cpu_bind_type = job_desc->cpu_bind_type;
-	detail_ptr->cpu_bind   = xstrdup(job_desc->cpu_bind);
+	detail_ptr->cpu_bind   = _job_str_get(job_desc->cpu_bind);
 	detail_ptr->cpu_freq_gov = job_desc->cpu_freq_gov;
 	detail_ptr->cpu_freq_max = job_desc->cpu_freq_max;
 	detail_ptr->cpu_freq_min = job_desc->cpu_freq_min;
@@ -8173,10 +8278,10 @@ static int _copy_job_desc_to_job_record(job_desc_msg_t *job_desc,
 		detail_ptr->pn_min_tmp_disk = job_desc->pn_min_tmp_disk;
 	if (job_desc->num_tasks != NO_VAL)
 		detail_ptr->num_tasks = job_desc->num_tasks;
-	detail_ptr->std_err = xstrdup(job_desc->std_err);
-	detail_ptr->std_in = xstrdup(job_desc->std_in);
-	detail_ptr->std_out = xstrdup(job_desc->std_out);
-	detail_ptr->work_dir = xstrdup(job_desc->work_dir);
+	detail_ptr->std_err = _job_str_get(job_desc->std_err);
+	detail_ptr->std_in = _job_str_get(job_desc->std_in);
+	detail_ptr->std_out = _job_str_get(job_desc->std_out);
+	detail_ptr->work_dir = _job_str_get(job_desc->work_dir);
 	if (job_desc->begin_time > time(NULL))
 		detail_ptr->begin_time = job_desc->begin_time;
 	job_ptr->select_jobinfo =
@@ -12941,8 +13046,8 @@ static int _update_job(job_record_t *job_ptr, job_desc_msg_t *job_specs,
 			error_code = ESLURM_JOB_NOT_PENDING;
 			goto fini;
 		} else if (detail_ptr) {
-			xfree(detail_ptr->work_dir);
-			detail_ptr->work_dir = xstrdup(job_specs->work_dir);
+			_job_str_put(&detail_ptr->work_dir);
+			detail_ptr->work_dir = _job_str_get(job_specs->work_dir);
 			sched_info("%s: setting work_dir to %s for %pJ",
 				   __func__, detail_ptr->work_dir, job_ptr);
 			update_accounting = true;
@@ -12957,8 +13062,8 @@ static int _update_job(job_record_t *job_ptr, job_desc_msg_t *job_specs,
 		if (!IS_JOB_PENDING(job_ptr))
 			error_code = ESLURM_JOB_NOT_PENDING;
 		else if (detail_ptr) {
-			xfree(detail_ptr->std_out);
-			detail_ptr->std_out = xstrdup(job_specs->std_out);
+			_job_str_put(&detail_ptr->std_out);
+			detail_ptr->std_out = _job_str_get(job_specs->std_out);
 		}
 	}
 	if (error_code != SLURM_SUCCESS)
@@ -15049,6 +15154,7 @@ void job_fini (void)
 	xfree(job_hash);
 	xfree(job_array_hash_j);
 	xfree(job_array_hash_t);
+	xhash_free(job_str_hash);
 	FREE_NULL_LIST(purge_files_list);
 	FREE_NULL_BITMAP(requeue_exit);
 	FREE_NULL_BITMAP(requeue_exit_hold);
@@ -72,6 +72,7 @@
 #include "src/common/track_script.h"
 #include "src/common/uid.h"
 #include "src/common/xassert.h"
+#include "src/common/xhash.h"
 #include "src/common/xstring.h"
 
 #include "src/slurmctld/acct_policy.h"
@@ -125,6 +126,8 @@ static bool	_job_runnable_test2(job_record_t *job_ptr, bool check_min_time);
 static void *	_run_epilog(void *arg);
 static void *	_run_prolog(void *arg);
 static bool	_scan_depend(List dependency_list, uint32_t job_id);
+static void	_split_bb_array_job(job_record_t *job_ptr);
+static void	_split_correspond_array_job(job_record_t *job_ptr);
 static void *	_sched_agent(void *args);
 static int	_schedule(uint32_t job_limit);
 static int	_valid_batch_features(job_record_t *job_ptr, bool can_reboot);
@@ -137,6 +140,7 @@ static int	build_queue_timeout = BUILD_TIMEOUT;
 static int	save_last_part_update = 0;
 
 static pthread_mutex_t sched_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sched_cond = PTHREAD_COND_INITIALIZER;
 static int sched_pend_thread = 0;
 static bool sched_running = false;
 static struct timeval sched_last = {0, 0};
@@ -229,6 +233,148 @@ static List _build_user_job_list(uint32_t user_id, char* job_name)
 	return job_queue;
 }
 
+/*
+ * Singleton dependency state for one user and job name, built in a single
+ * pass over the job list while build_job_queue() tests every pending job.
+ * No job starts during that pass, so the records stay valid until
+ * _singleton_cache_end() is called.
+ */
+typedef struct {
+	char *key;		/* "<user_id>/<name>" or "<user_id>" if no name */
+	bool active;		/* a matching job is running or suspended */
+	uint32_t min_pending_id;/* lowest matching pending job id */
+} singleton_rec_t;
+
+static bool singleton_cache = false;
+static xhash_t *singleton_hash = NULL;
+
+/* Fetch key from xhash_t item. Called from function ptr */
+static void _singleton_rec_id(void *item, const char **key,
+			      uint32_t *key_len)
+{
+	singleton_rec_t *rec = (singleton_rec_t *) item;
+
+	*key = rec->key;
+	*key_len = strlen(rec->key);
+}
+
+static void _singleton_rec_free(void *item)
+{
+	singleton_rec_t *rec = (singleton_rec_t *) item;
+
+	xfree(rec->key);
+	xfree(rec);
+}
+
+static char *_singleton_key(uint32_t user_id, char *job_name)
+{
+	if (job_name)
+		return xstrdup_printf("%u/%s", user_id, job_name);
+	return xstrdup_printf("%u", user_id);
+}
+
+static void _singleton_hash_build(void)
+{
+	ListIterator job_iterator;
+	job_record_t *job_ptr;
+	singleton_rec_t *rec;
+	char *key;
+
+	singleton_hash = xhash_init(_singleton_rec_id, _singleton_rec_free);
+	job_iterator = list_iterator_create(job_list);
+	while ((job_ptr = list_next(job_iterator))) {
+		if (!IS_JOB_RUNNING(job_ptr) && !IS_JOB_SUSPENDED(job_ptr) &&
+		    !IS_JOB_PENDING(job_ptr))
+			continue;
+		key = _singleton_key(job_ptr->user_id, job_ptr->name);
+		if (!(rec = xhash_get(singleton_hash, key, strlen(key)))) {
+			rec = xmalloc(sizeof(singleton_rec_t));
+			rec->key = key;
+			rec->min_pending_id = NO_VAL;
+			xhash_add(singleton_hash, rec);
+		} else
+			xfree(key);
+		if (IS_JOB_PENDING(job_ptr)) {
+			if (job_ptr->job_id < rec->min_pending_id)
+				rec->min_pending_id = job_ptr->job_id;
+		} else
+			rec->active = true;
+	}
+	list_iterator_destroy(job_iterator);
+}
+
+/*
+ * Start/stop caching singleton dependency state. Only valid while no job
+ * starts or is submitted between the two calls.
+ */
+static void _singleton_cache_begin(void)
+{
+	singleton_cache = true;
+}
+
+static void _singleton_cache_end(void)
+{
+	singleton_cache = false;
+	xhash_free(singleton_hash);
+}
+
+static bool _singleton_rec_blocks(uint32_t user_id, char *job_name,
+				  uint32_t job_id)
+{
+	singleton_rec_t *rec;
+	char *key = _singleton_key(user_id, job_name);
+
+	rec = xhash_get(singleton_hash, key, strlen(key));
+	xfree(key);
+	if (!rec)
+		return false;
+
+	return (rec->active || (rec->min_pending_id < job_id));
+}
+
+/*
+ * _singleton_runnable - test if a job with a singleton dependency can run,
+ *	no other job of the same user and name (or without a name) may be
+ *	running, suspended or pending with a lower job id
+ */
+static bool _singleton_runnable(job_record_t *job_ptr)
+{
+	List job_queue;
+	ListIterator job_iterator;
+	job_record_t *qjob_ptr;
+	bool run_now = true;
+
+	if (singleton_cache) {
+		if (!singleton_hash)
+			_singleton_hash_build();
+		if (_singleton_rec_blocks(job_ptr->user_id, job_ptr->name,
+					  job_ptr->job_id) ||
+		    _singleton_rec_blocks(job_ptr->user_id, NULL,
+					  job_ptr->job_id))
+			return false;
+		return true;
+	}
+
+	/* get user jobs with the same user and name */
+	job_queue = _build_user_job_list(job_ptr->user_id, job_ptr->name);
+	job_iterator = list_iterator_create(job_queue);
+	while ((qjob_ptr = list_next(job_iterator))) {
+		/* already running/suspended job or previously
+		 * submitted pending job */
+		if (IS_JOB_RUNNING(qjob_ptr) ||
+		    IS_JOB_SUSPENDED(qjob_ptr) ||
+		    (IS_JOB_PENDING(qjob_ptr) &&
+		     (qjob_ptr->job_id < job_ptr->job_id))) {
+			run_now = false;
+			break;
+		}
+	}
+	list_iterator_destroy(job_iterator);
+	FREE_NULL_LIST(job_queue);
+
+	return run_now;
+}
+
 static void _job_queue_append(List job_queue, job_record_t *job_ptr,
 			      part_record_t *part_ptr, uint32_t prio)
 {
@@ -388,6 +534,91 @@ static bool _job_runnable_test3(job_record_t *job_ptr, part_record_t *part_ptr)
 	return true;
 }
 
+/* Split out a task of a pending job array which needs burst buffer staging */
+static void _split_bb_array_job(job_record_t *job_ptr)
+{
+	job_record_t *new_job_ptr;
+	int i, pend_cnt;
+
+	if ((i = bit_ffs(job_ptr->array_recs->task_id_bitmap)) < 0)
+		return;
+	pend_cnt = num_pending_job_array_tasks(job_ptr->array_job_id);
+	if (pend_cnt >= bb_array_stage_cnt)
+		return;
+	if (job_ptr->array_recs->task_cnt < 1)
+		return;
+	if (job_ptr->array_recs->task_cnt == 1) {
+		job_ptr->array_task_id = i;
+		(void) job_array_post_sched(job_ptr);
+		return;
+	}
+	job_ptr->array_task_id = i;
+	new_job_ptr = job_array_split(job_ptr);
+	if (new_job_ptr) {
+		debug("%s: Split out %pJ for burst buffer use",
+		      __func__, job_ptr);
+		new_job_ptr->job_state = JOB_PENDING;
+		new_job_ptr->start_time = (time_t) 0;
+		/* Do NOT clear db_index here, it is handled when
+		 * task_id_str is created elsewhere */
+		(void) bb_g_job_validate2(job_ptr, NULL);
+	} else {
+		error("%s: Unable to copy record for %pJ",
+		      __func__, job_ptr);
+	}
+}
+
+/* Split out a task of a pending job array with depend_type ==
+ * SLURM_DEPEND_AFTER_CORRESPOND */
+static void _split_correspond_array_job(job_record_t *job_ptr)
+{
+	ListIterator depend_iter;
+	struct depend_spec *dep_ptr;
+	job_record_t *new_job_ptr;
+	int i, pend_cnt, dep_corr;
+
+	if ((i = bit_ffs(job_ptr->array_recs->task_id_bitmap)) < 0)
+		return;
+	if ((job_ptr->details == NULL) ||
+	    (job_ptr->details->depend_list == NULL) ||
+	    (list_count(job_ptr->details->depend_list) == 0))
+		return;
+	depend_iter = list_iterator_create(job_ptr->details->depend_list);
+	dep_corr = 0;
+	while ((dep_ptr = list_next(depend_iter))) {
+		if (dep_ptr->depend_type == SLURM_DEPEND_AFTER_CORRESPOND) {
+			dep_corr = 1;
+			break;
+		}
+	}
+	list_iterator_destroy(depend_iter);
+	if (!dep_corr)
+		return;
+	pend_cnt = num_pending_job_array_tasks(job_ptr->array_job_id);
+	if (pend_cnt >= CORRESPOND_ARRAY_TASK_CNT)
+		return;
+	if (job_ptr->array_recs->task_cnt < 1)
+		return;
+	if (job_ptr->array_recs->task_cnt == 1) {
+		job_ptr->array_task_id = i;
+		(void) job_array_post_sched(job_ptr);
+		return;
+	}
+	job_ptr->array_task_id = i;
+	new_job_ptr = job_array_split(job_ptr);
+	if (new_job_ptr) {
+		info("%s: Split out %pJ for SLURM_DEPEND_AFTER_CORRESPOND use",
+		     __func__, job_ptr);
+		new_job_ptr->job_state = JOB_PENDING;
+		new_job_ptr->start_time = (time_t) 0;
+		/* Do NOT clear db_index here, it is handled when
+		 * task_id_str is created elsewhere */
+	} else {
+		error("%s: Unable to copy record for %pJ",
+		      __func__, job_ptr);
+	}
+}
+
 /*
  * build_job_queue - build (non-priority ordered) list of pending jobs
  * IN clear_start - if set then clear the start_time for pending jobs,
@@ -400,11 +631,10 @@ extern List build_job_queue(bool clear_start, bool backfill)
 {
 	static time_t last_log_time = 0;
 	List job_queue;
-	ListIterator depend_iter, job_iterator, part_iterator;
-	job_record_t *job_ptr = NULL, *new_job_ptr;
+	ListIterator job_iterator, part_iterator;
+	job_record_t *job_ptr = NULL;
 	part_record_t *part_ptr;
-	struct depend_spec *dep_ptr;
-	int i, pend_cnt, reason, dep_corr;
+	int reason;
 	struct timeval start_tv = {0, 0};
 	int tested_jobs = 0;
 	int job_part_pairs = 0;
@@ -414,47 +644,12 @@ extern List build_job_queue(bool clear_start, bool backfill)
 	(void) slurm_delta_tv(&start_tv);
 	job_queue = list_create(_job_queue_rec_del);
 
-	/* Create individual job records for job arrays that need burst buffer
-	 * staging */
-	job_iterator = list_iterator_create(job_list);
-	while ((job_ptr = list_next(job_iterator))) {
-		if (!IS_JOB_PENDING(job_ptr) ||
-		    !job_ptr->burst_buffer || !job_ptr->array_recs ||
-		    !job_ptr->array_recs->task_id_bitmap ||
-		    (job_ptr->array_task_id != NO_VAL))
-			continue;
-
-		if ((i = bit_ffs(job_ptr->array_recs->task_id_bitmap)) < 0)
-			continue;
-		pend_cnt = num_pending_job_array_tasks(job_ptr->array_job_id);
-		if (pend_cnt >= bb_array_stage_cnt)
-			continue;
-		if (job_ptr->array_recs->task_cnt < 1)
-			continue;
-		if (job_ptr->array_recs->task_cnt == 1) {
-			job_ptr->array_task_id = i;
-			(void) job_array_post_sched(job_ptr);
-			continue;
-		}
-		job_ptr->array_task_id = i;
-		new_job_ptr = job_array_split(job_ptr);
-		if (new_job_ptr) {
-			debug("%s: Split out %pJ for burst buffer use",
-			      __func__, job_ptr);
-			new_job_ptr->job_state = JOB_PENDING;
-			new_job_ptr->start_time = (time_t) 0;
-			/* Do NOT clear db_index here, it is handled when
-			 * task_id_str is created elsewhere */
-			(void) bb_g_job_validate2(job_ptr, NULL);
-		} else {
-			error("%s: Unable to copy record for %pJ",
-			      __func__, job_ptr);
-		}
-	}
-	list_iterator_destroy(job_iterator);
-
-	/* Create individual job records for job arrays with
-	 * depend_type == SLURM_DEPEND_AFTER_CORRESPOND */
+	/*
+	 * Create individual job records for job arrays that need burst buffer
+	 * staging or have depend_type == SLURM_DEPEND_AFTER_CORRESPOND. Both
+	 * only apply to pending job array meta records, so find them in one
+	 * pass rather than walking the whole job list once for each.
+	 */
 	job_iterator = list_iterator_create(job_list);
 	while ((job_ptr = list_next(job_iterator))) {
 		if (!IS_JOB_PENDING(job_ptr) ||
@@ -462,50 +657,21 @@ extern List build_job_queue(bool clear_start, bool backfill)
 		    !job_ptr->array_recs->task_id_bitmap ||
 		    (job_ptr->array_task_id != NO_VAL))
 			continue;
-		if ((i = bit_ffs(job_ptr->array_recs->task_id_bitmap)) < 0)
-			continue;
-		if ((job_ptr->details == NULL) ||
-		    (job_ptr->details->depend_list == NULL) ||
-		    (list_count(job_ptr->details->depend_list) == 0))
-			continue;
-		depend_iter = list_iterator_create(
-			job_ptr->details->depend_list);
-		dep_corr = 0;
-		while ((dep_ptr = list_next(depend_iter))) {
-			if (dep_ptr->depend_type ==
-			    SLURM_DEPEND_AFTER_CORRESPOND) {
-				dep_corr = 1;
-				break;
-			}
-		}
-		if (!dep_corr)
-			continue;
-		pend_cnt = num_pending_job_array_tasks(job_ptr->array_job_id);
-		if (pend_cnt >= CORRESPOND_ARRAY_TASK_CNT)
-			continue;
-		if (job_ptr->array_recs->task_cnt < 1)
-			continue;
-		if (job_ptr->array_recs->task_cnt == 1) {
-			job_ptr->array_task_id = i;
-			(void) job_array_post_sched(job_ptr);
-			continue;
-		}
-		job_ptr->array_task_id = i;
-		new_job_ptr = job_array_split(job_ptr);
-		if (new_job_ptr) {
-			info("%s: Split out %pJ for SLURM_DEPEND_AFTER_CORRESPOND use",
-			     __func__, job_ptr);
-			new_job_ptr->job_state = JOB_PENDING;
-			new_job_ptr->start_time = (time_t) 0;
-			/* Do NOT clear db_index here, it is handled when
-			 * task_id_str is created elsewhere */
-		} else {
-			error("%s: Unable to copy record for %pJ",
-			      __func__, job_ptr);
-		}
+
+		if (job_ptr->burst_buffer)
+			_split_bb_array_job(job_ptr);
+		/* Skip if just split, the new meta record is visited later */
+		if (job_ptr->array_task_id == NO_VAL)
+			_split_correspond_array_job(job_ptr);
 	}
 	list_iterator_destroy(job_iterator);
 
+	/*
+	 * No job starts below and jobs only leave the pending state when
+	 * their dependency is invalid, which at worst delays a singleton
+	 * job until the next pass, so singleton tests can share one scan.
+	 */
+	_singleton_cache_begin();
 	job_iterator = list_iterator_create(job_list);
 	while ((job_ptr = list_next(job_iterator))) {
 		if (IS_JOB_PENDING(job_ptr))
@@ -597,6 +763,7 @@ extern List build_job_queue(bool clear_start, bool backfill)
 		}
 	}
 	list_iterator_destroy(job_iterator);
+	_singleton_cache_end();
 
 	return job_queue;
 }
@@ -801,6 +968,7 @@ extern int schedule(uint32_t job_limit)
 		sched_last.tv_sec  = now.tv_sec;
 		sched_last.tv_usec = now.tv_usec;
 		sched_running = false;
+		slurm_cond_broadcast(&sched_cond);
 		slurm_mutex_unlock(&sched_mutex);
 	} else if (sched_pend_thread == 0) {
 		/* We don't want to run now, but also don't want to defer
@@ -819,26 +987,37 @@ extern int schedule(uint32_t job_limit)
 /* Thread used to possibly start job scheduler later, if nothing else does */
 static void *_sched_agent(void *args)
 {
-	long delta_t;
+	long delta_t, wait_usec;
 	struct timeval now;
-	useconds_t usec;
+	struct timespec ts;
 	int job_cnt;
 
-	usec = sched_min_interval / 2;
-	usec = MIN(usec, 1000000);
-	usec = MAX(usec, 10000);
-
-	/* Keep waiting until scheduler() can really run */
+	/*
+	 * Keep waiting until scheduler() can really run. Rather than polling,
+	 * sleep until exactly sched_min_interval after the last run ends, or
+	 * until a running scheduler signals its completion. Wake at least
+	 * once per second to notice shutdown.
+	 */
+	slurm_mutex_lock(&sched_mutex);
 	while (!slurmctld_config.shutdown_time) {
-		usleep(usec);
-		if (sched_running)
-			continue;
 		gettimeofday(&now, NULL);
-		delta_t  = (now.tv_sec  - sched_last.tv_sec) * USEC_IN_SEC;
-		delta_t +=  now.tv_usec - sched_last.tv_usec;
-		if (delta_t >= sched_min_interval)
-			break;
+		if (sched_running) {
+			wait_usec = USEC_IN_SEC;
+		} else {
+			delta_t  = (now.tv_sec  - sched_last.tv_sec) *
+				   USEC_IN_SEC;
+			delta_t +=  now.tv_usec - sched_last.tv_usec;
+			if (delta_t >= sched_min_interval)
+				break;
+			wait_usec = MIN(sched_min_interval - delta_t,
+					USEC_IN_SEC);
+		}
+		wait_usec += now.tv_usec;
+		ts.tv_sec  = now.tv_sec + (wait_usec / USEC_IN_SEC);
+		ts.tv_nsec = (wait_usec % USEC_IN_SEC) * 1000;
+		slurm_cond_timedwait(&sched_cond, &sched_mutex, &ts);
 	}
+	slurm_mutex_unlock(&sched_mutex);
 
 	job_cnt = schedule(0);
 	slurm_mutex_lock(&sched_mutex);
@@ -2831,14 +3010,12 @@ static int _test_job_dependency_common(
  */
 extern int test_job_dependency(job_record_t *job_ptr)
 {
-	ListIterator depend_iter, job_iterator;
+	ListIterator depend_iter;
 	struct depend_spec *dep_ptr;
 	bool failure = false, depends = false, rebuild_str = false;
 	bool or_satisfied = false;
-	List job_queue = NULL;
-	bool run_now;
 	int results = 0;
-	job_record_t *qjob_ptr, *djob_ptr;
+	job_record_t *djob_ptr;
 	bool is_complete, is_completed, is_pending;
 
 	if ((job_ptr->details == NULL) ||
@@ -2856,26 +3033,8 @@ extern int test_job_dependency(job_record_t *job_ptr)
 		djob_ptr = dep_ptr->job_ptr;
 		if ((dep_ptr->depend_type == SLURM_DEPEND_SINGLETON) &&
 		    job_ptr->name) {
-			/* get user jobs with the same user and name */
-			job_queue = _build_user_job_list(job_ptr->user_id,
-							 job_ptr->name);
-			run_now = true;
-			job_iterator = list_iterator_create(job_queue);
-			while ((qjob_ptr = list_next(job_iterator))) {
-				/* already running/suspended job or previously
-				 * submitted pending job */
-				if (IS_JOB_RUNNING(qjob_ptr) ||
-				    IS_JOB_SUSPENDED(qjob_ptr) ||
-				    (IS_JOB_PENDING(qjob_ptr) &&
-				     (qjob_ptr->job_id < job_ptr->job_id))) {
-					run_now = false;
-					break;
-				}
-			}
-			list_iterator_destroy(job_iterator);
-			FREE_NULL_LIST(job_queue);
 			/* job can run now, delete dependency */
-			if (run_now)
+			if (_singleton_runnable(job_ptr))
 				list_delete_item(depend_iter);
 			else
 				depends = true;
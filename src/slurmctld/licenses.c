@@ -48,6 +48,7 @@
 #include "src/common/list.h"
 #include "src/common/log.h"
 #include "src/common/macros.h"
+#include "src/common/xhash.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 #include "src/slurmctld/licenses.h"
@@ -58,6 +59,7 @@
 List license_list = (List) NULL;
 time_t last_license_update = 0;
 static pthread_mutex_t license_mutex = PTHREAD_MUTEX_INITIALIZER;
+static xhash_t *license_hash = NULL;	/* license_list indexed by name */
 static void _pack_license(struct licenses *lic, Buf buffer, uint16_t protocol_version);
 
 /* Print all licenses on a list */
@@ -120,6 +122,53 @@ static int _license_find_remote_rec(void *x, void *key)
 	return _license_find_rec(x, key);
 }
 
+/* Fetch key from xhash_t item. Called from function ptr */
+static void _license_id(void *item, const char **key, uint32_t *key_len)
+{
+	licenses_t *license_entry = (licenses_t *) item;
+
+	*key = license_entry->name;
+	*key_len = strlen(license_entry->name) + 1;
+}
+
+/*
+ * Rebuild license_hash after license_list has been replaced or records
+ * removed from it. Where names repeat, the first record in
+ * license_list is indexed, as list_find_first() would return.
+ * license_mutex should be locked before calling this.
+ */
+static void _license_hash_rebuild(void)
+{
+	licenses_t *license_entry;
+	ListIterator iter;
+
+	xhash_free(license_hash);
+	if (!license_list)
+		return;
+
+	license_hash = xhash_init(_license_id, NULL);
+	iter = list_iterator_create(license_list);
+	while ((license_entry = list_next(iter))) {
+		if (!license_entry->name ||
+		    xhash_get(license_hash, license_entry->name,
+			      strlen(license_entry->name) + 1))
+			continue;
+		xhash_add(license_hash, license_entry);
+	}
+	list_iterator_destroy(iter);
+}
+
+/*
+ * Find a license_t record in license_list by license name.
+ * license_mutex should be locked before calling this.
+ */
+static licenses_t *_license_find(char *name)
+{
+	if (!license_hash || !name)
+		return NULL;
+	return xhash_get(license_hash, name, strlen(name) + 1);
+}
+
 /* Given a license string, return a list of license_t records */
 static List _build_license_list(char *licenses, bool *valid)
 {
@@ -217,6 +266,17 @@ static void _add_res_rec_2_lic_list(slurmdb_res_rec_t *rec, bool sync)
 	license_entry->remote = sync ? 2 : 1;
 
 	list_push(license_list, license_entry);
+	/*
+	 * The record is now first in license_list, so it replaces any indexed
+	 * record of the same name, as list_find_first() would.
+	 */
+	if (!license_hash)
+		_license_hash_rebuild();
+	else {
+		xhash_pop(license_hash, license_entry->name,
+			  strlen(license_entry->name) + 1);
+		xhash_add(license_hash, license_entry);
+	}
 	last_license_update = time(NULL);
 }
 
@@ -259,6 +319,7 @@ extern int license_init(char *licenses)
 	license_list = _build_license_list(licenses, &valid);
 	if (!valid)
 		fatal("Invalid configured licenses: %s", licenses);
+	_license_hash_rebuild();
 
 	_licenses_print("init_license", license_list, NULL);
 	slurm_mutex_unlock(&license_mutex);
@@ -281,6 +342,7 @@ extern int license_update(char *licenses)
         slurm_mutex_lock(&license_mutex);
         if (!license_list) {        /* no licenses before now */
                 license_list = new_list;
+                _license_hash_rebuild();
                 slurm_mutex_unlock(&license_mutex);
                 return SLURM_SUCCESS;
         }
@@ -317,6 +379,7 @@ extern int license_update(char *licenses)
 
         FREE_NULL_LIST(license_list);
         license_list = new_list;
+        _license_hash_rebuild();
         _licenses_print("update_license", license_list, NULL);
         slurm_mutex_unlock(&license_mutex);
         return SLURM_SUCCESS;
@@ -426,6 +489,7 @@ extern void license_remove_remote(slurmdb_res_rec_t *rec)
 			     "removed with %u in use",
 			     license_entry->name, license_entry->used);
 			list_delete_item(iter);
+			_license_hash_rebuild();
 			last_license_update = time(NULL);
 			break;
 		}
@@ -499,6 +563,7 @@ extern void license_sync_remote(List res_list)
 			license_entry->remote = 1;
 	}
 	list_iterator_destroy(iter);
+	_license_hash_rebuild();
 
 	slurm_mutex_unlock(&license_mutex);
 }
@@ -507,6 +572,7 @@ extern void license_sync_remote(List res_list)
 extern void license_free(void)
 {
 	slurm_mutex_lock(&license_mutex);
+	xhash_free(license_hash);
 	FREE_NULL_LIST(license_list);
 	slurm_mutex_unlock(&license_mutex);
 }
@@ -551,12 +617,7 @@ extern List license_validate(char *licenses, bool validate_configured,
 	_licenses_print("request_license", job_license_list, NULL);
 	iter = list_iterator_create(job_license_list);
 	while ((license_entry = list_next(iter))) {
-		if (license_list) {
-			match = list_find_first(license_list,
-						_license_find_rec,
-						license_entry->name);
-		} else
-			match = NULL;
+		match = _license_find(license_entry->name);
 		if (!match) {
 			debug("License name requested (%s) does not exist",
 			      license_entry->name);
@@ -627,8 +688,7 @@ extern int license_job_test(job_record_t *job_ptr, time_t when, bool reboot)
 	slurm_mutex_lock(&license_mutex);
 	iter = list_iterator_create(job_ptr->license_list);
 	while ((license_entry = list_next(iter))) {
-		match = list_find_first(license_list, _license_find_rec,
-			license_entry->name);
+		match = _license_find(license_entry->name);
 		if (!match) {
 			error("could not find license %s for job %u",
 			      license_entry->name, job_ptr->job_id);
@@ -706,8 +766,7 @@ extern int license_job_get(job_record_t *job_ptr)
 	slurm_mutex_lock(&license_mutex);
 	iter = list_iterator_create(job_ptr->license_list);
 	while ((license_entry = list_next(iter))) {
-		match = list_find_first(license_list, _license_find_rec,
-			license_entry->name);
+		match = _license_find(license_entry->name);
 		if (match) {
 			match->used += license_entry->total;
 			license_entry->used += license_entry->total;
@@ -742,8 +801,7 @@ extern int license_job_return(job_record_t *job_ptr)
 	slurm_mutex_lock(&license_mutex);
 	iter = list_iterator_create(job_ptr->license_list);
 	while ((license_entry = list_next(iter))) {
-		match = list_find_first(license_list, _license_find_rec,
-			license_entry->name);
+		match = _license_find(license_entry->name);
 		if (match) {
 			if (match->used >= license_entry->total)
 				match->used -= license_entry->total;
@@ -854,13 +912,8 @@ extern uint32_t get_total_license_cnt(char *name)
 	licenses_t *lic;
 
 	slurm_mutex_lock(&license_mutex);
-	if (license_list) {
-		lic = list_find_first(
-			license_list, _license_find_rec, name);
-
-		if (lic)
-			count = lic->total;
-	}
+	if ((lic = _license_find(name)))
+		count = lic->total;
 	slurm_mutex_unlock(&license_mutex);
 
 	return count;
@@ -1089,7 +1089,7 @@ static void _find_qos_grp_node_bitmap(job_record_t *job_ptr,
 	    (qos_ptr->max_tres_pu_ctld[TRES_ARRAY_NODE] != INFINITE64)) {
 		*per_user_limit = true;
 		used_limits = acct_policy_get_user_used_limits(
-			&qos_ptr->usage->user_limit_list,
+			qos_ptr->usage,
 			job_ptr->user_id);
 		if (used_limits && used_limits->node_bitmap) {
 			if (*grp_node_bitmap)
@@ -1106,7 +1106,7 @@ static void _find_qos_grp_node_bitmap(job_record_t *job_ptr,
 	    (qos_ptr->max_tres_pa_ctld[TRES_ARRAY_NODE] != INFINITE64)) {
 		*per_acct_limit = true;
 		used_limits = acct_policy_get_acct_used_limits(
-			&qos_ptr->usage->acct_limit_list,
+			qos_ptr->usage,
 			job_ptr->assoc_ptr->acct);
 		if (used_limits && used_limits->node_bitmap) {
 			if (*grp_node_bitmap)
@@ -95,6 +95,7 @@ time_t last_config = (time_t) 0;
 time_t last_log = (time_t) 0, last_work_scan = (time_t) 0;
 uint16_t slurmd_timeout;
 static bool idle_on_node_suspend = false;
+static bool resume_planned_nodes = false;
 
 typedef struct exc_node_partital {
 	int exc_node_cnt;
@@ -256,6 +257,49 @@ static int _pick_exc_nodes(void *x, void *arg)
 	return 0;
 }
 
+/*
+ * Build a bitmap of the nodes backfill has planned for pending jobs that are
+ * expected to start within ResumeTimeout, so they can be resumed ahead of
+ * the allocation rather than after it. Returns NULL if there are none.
+ * Job read lock must be held.
+ */
+static bitstr_t *_planned_node_bitmap(time_t now)
+{
+	ListIterator job_iterator;
+	job_record_t *job_ptr;
+	bitstr_t *planned_bitmap = NULL, *job_bitmap = NULL;
+	time_t horizon = now + resume_timeout;
+
+	job_iterator = list_iterator_create(job_list);
+	while ((job_ptr = list_next(job_iterator))) {
+		if (!IS_JOB_PENDING(job_ptr) || !job_ptr->sched_nodes ||
+		    (job_ptr->start_time == 0) ||
+		    (job_ptr->start_time > horizon))
+			continue;
+		if (node_name2bitmap(job_ptr->sched_nodes, false,
+				     &job_bitmap)) {
+			FREE_NULL_BITMAP(job_bitmap);
+			continue;
+		}
+		if (planned_bitmap) {
+			bit_or(planned_bitmap, job_bitmap);
+			FREE_NULL_BITMAP(job_bitmap);
+		} else {
+			planned_bitmap = job_bitmap;
+			job_bitmap = NULL;
+		}
+	}
+	list_iterator_destroy(job_iterator);
+
+	if (planned_bitmap && power_save_debug) {
+		char *tmp = bitmap2node_name(planned_bitmap);
+		info("power_save: nodes planned for pending jobs %s", tmp);
+		xfree(tmp);
+	}
+
+	return planned_bitmap;
+}
+
 /* Perform any power change work to nodes */
 static void _do_power_work(time_t now)
 {
@@ -264,6 +308,7 @@ static void _do_power_work(time_t now)
 	uint32_t susp_state;
 	bitstr_t *avoid_node_bitmap = NULL, *failed_node_bitmap = NULL;
 	bitstr_t *wake_node_bitmap = NULL, *sleep_node_bitmap = NULL;
+	bitstr_t *planned_node_bitmap = NULL;
 	node_record_t *node_ptr;
 
 	if (last_work_scan == 0) {
@@ -331,6 +376,8 @@ static void _do_power_work(time_t now)
 		else
 			avoid_node_bitmap = bit_copy(exc_node_bitmap);
 	}
+	if (resume_planned_nodes)
+		planned_node_bitmap = _planned_node_bitmap(now);
 
 	/* Build bitmaps identifying each node which should change state */
 	for (i = 0, node_ptr = node_record_table_ptr;
@@ -345,7 +392,9 @@ static void _do_power_work(time_t now)
 		    ((resume_rate == 0) || (resume_cnt < resume_rate))	&&
 		    !IS_NODE_POWERING_DOWN(node_ptr) &&
 		    (IS_NODE_ALLOCATED(node_ptr) ||
-		     (node_ptr->last_idle > (now - idle_time)))) {
+		     (node_ptr->last_idle > (now - idle_time)) ||
+		     (planned_node_bitmap &&
+		      bit_test(planned_node_bitmap, i)))) {
 			if (wake_node_bitmap == NULL) {
 				wake_node_bitmap =
 					bit_alloc(node_record_count);
@@ -374,7 +423,9 @@ static void _do_power_work(time_t now)
 		    (node_ptr->last_idle != 0)				&&
 		    (node_ptr->last_idle < (now - idle_time))		&&
 		    ((avoid_node_bitmap == NULL) ||
-		     (bit_test(avoid_node_bitmap, i) == 0))) {
+		     (bit_test(avoid_node_bitmap, i) == 0))		&&
+		    ((planned_node_bitmap == NULL) ||
+		     (bit_test(planned_node_bitmap, i) == 0))) {
 			if (sleep_node_bitmap == NULL) {
 				sleep_node_bitmap =
 					bit_alloc(node_record_count);
@@ -455,6 +506,7 @@ static void _do_power_work(time_t now)
 		}
 	}
 	FREE_NULL_BITMAP(avoid_node_bitmap);
+	FREE_NULL_BITMAP(planned_node_bitmap);
 	if (power_save_debug && ((now - last_log) > 600) && (susp_total > 0)) {
 		info("Power save mode: %d nodes", susp_total);
 		last_log = now;
@@ -874,6 +926,8 @@ static int _init_power_config(void)
 
 	idle_on_node_suspend = xstrcasestr(slurmctld_conf.slurmctld_params,
 					   "idle_on_node_suspend");
+	resume_planned_nodes = xstrcasestr(slurmctld_conf.slurmctld_params,
+					   "power_save_resume_planned");
 
 	if (idle_time < 0) {	/* not an error */
 		debug("power_save module disabled, SuspendTime < 0");
@@ -1023,6 +1077,9 @@ static void *_init_power_save(void *arg)
         /* Locks: Write nodes */
         slurmctld_lock_t node_write_lock = {
                 NO_LOCK, NO_LOCK, WRITE_LOCK, NO_LOCK, NO_LOCK };
+	/* Locks: Read jobs, write nodes */
+	slurmctld_lock_t job_read_node_write_lock = {
+		NO_LOCK, READ_LOCK, WRITE_LOCK, NO_LOCK, NO_LOCK };
 	time_t now, boot_time = 0, last_power_scan = 0;
 
 	if (power_save_config && !power_save_enabled) {
@@ -1054,9 +1111,15 @@ static void *_init_power_save(void *arg)
 		 */
 		if ((last_node_update >= last_power_scan) ||
 		    (now >= (last_power_scan + 10))) {
-			lock_slurmctld(node_write_lock);
-			_do_power_work(now);
-			unlock_slurmctld(node_write_lock);
+			if (resume_planned_nodes) {
+				lock_slurmctld(job_read_node_write_lock);
+				_do_power_work(now);
+				unlock_slurmctld(job_read_node_write_lock);
+			} else {
+				lock_slurmctld(node_write_lock);
+				_do_power_work(now);
+				unlock_slurmctld(node_write_lock);
+			}
 			last_power_scan = now;
 		}
 
@@ -5061,18 +5061,21 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 
 		/*
 		 * if there are any overlapping reservations, we need to
-		 * prevent the job from using those nodes (e.g. MAINT nodes)
+		 * prevent the job from using those nodes (e.g. MAINT nodes).
+		 * Jobs in a MAINT reservation can use all of its nodes.
 		 */
-		iter = list_iterator_create(resv_list);
-		while ((res2_ptr = list_next(iter))) {
+		if (resv_ptr->flags & RESERVE_FLAG_MAINT)
+			iter = NULL;
+		else
+			iter = list_iterator_create(resv_list);
+		while (iter && (res2_ptr = list_next(iter))) {
 			if (reboot)
 				job_end_time_use =
 					job_end_time + res2_ptr->boot_time;
 			else
 				job_end_time_use = job_end_time;
 
-			if ((resv_ptr->flags & RESERVE_FLAG_MAINT) ||
-			    ((resv_ptr->flags & RESERVE_FLAG_OVERLAP) &&
+			if (((resv_ptr->flags & RESERVE_FLAG_OVERLAP) &&
 			     !(res2_ptr->flags & RESERVE_FLAG_MAINT)) ||
 			    (res2_ptr == resv_ptr) ||
 			    (res2_ptr->node_bitmap == NULL) ||
@@ -5085,7 +5088,8 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 				bit_and_not(*node_bitmap,res2_ptr->node_bitmap);
 			}
 		}
-		list_iterator_destroy(iter);
+		if (iter)
+			list_iterator_destroy(iter);
 
 		if (slurmctld_conf.debug_flags & DEBUG_FLAG_RESERVATION) {
 			char *nodes = bitmap2node_name(*node_bitmap);
@@ -5223,7 +5227,10 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 				}
 			}
 
-			if(!job_ptr->part_ptr ||
+			/* Overlap already found, skip the bitmap test */
+			if (*resv_overlap)
+				continue;
+			if (!job_ptr->part_ptr ||
 			    bit_overlap_any(job_ptr->part_ptr->node_bitmap,
 					    resv_ptr->node_bitmap)) {
 				*resv_overlap = true;
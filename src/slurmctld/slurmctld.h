@@ -65,6 +65,7 @@
 #include "src/common/slurm_protocol_defs.h"
 #include "src/common/switch.h"
 #include "src/common/timers.h"
+#include "src/common/xhash.h"
 #include "src/common/xmalloc.h"
 
 /*****************************************************************************\
@@ -501,7 +502,10 @@ typedef struct job_feature {
 #define WHOLE_NODE_MCS		0x03
 
 /* job_details - specification of a job's constraints,
- * can be purged after initiation */
+ * can be purged after initiation
+ * NOTE: acctg_freq, argv[], cpu_bind, mem_bind, std_err, std_in, std_out and
+ * work_dir strings are shared between job records, see _job_str_get() in
+ * job_mgr.c, never modify or xfree() them */
 struct job_details {
 	uint32_t magic;			/* magic cookie for data integrity */
 					/* DO NOT ALPHABETIZE */
@@ -829,6 +833,8 @@ struct job_record {
 					 * priority or resources, only stored in
 					 * the database. */
 	List step_list;			/* list of job's steps */
+	xhash_t *step_hash;		/* step_list records indexed by
+					 * step_id, see find_step_record() */
 	time_t suspend_time;		/* time job last suspended or resumed */
 	char *system_comment;		/* slurmctld's arbitrary comment */
 	time_t time_last_active;	/* time of last job activity */
@@ -155,6 +155,44 @@ static int _opt_node_cnt(uint32_t step_min_nodes, uint32_t step_max_nodes,
 	return target_node_cnt;
 }
 
+/* Fetch key from xhash_t item. Called from function ptr */
+static void _step_id(void *item, const char **key, uint32_t *key_len)
+{
+	step_record_t *step_ptr = (step_record_t *) item;
+
+	*key = (const char *) &step_ptr->step_id;
+	*key_len = sizeof(step_ptr->step_id);
+}
+
+/*
+ * Index a step record by its step_id once that has been assigned. Pending
+ * placeholder steps all share SLURM_PENDING_STEP and are left to the list.
+ */
+static void _step_hash_add(step_record_t *step_ptr)
+{
+	job_record_t *job_ptr = step_ptr->job_ptr;
+
+	if (step_ptr->step_id == SLURM_PENDING_STEP)
+		return;
+	if (!job_ptr->step_hash)
+		job_ptr->step_hash = xhash_init(_step_id, NULL);
+	if (!xhash_get(job_ptr->step_hash, (char *) &step_ptr->step_id,
+		       sizeof(step_ptr->step_id)))
+		xhash_add(job_ptr->step_hash, step_ptr);
+}
+
+static void _step_hash_remove(step_record_t *step_ptr)
+{
+	job_record_t *job_ptr = step_ptr->job_ptr;
+
+	if (!job_ptr || !job_ptr->step_hash)
+		return;
+	if (xhash_get(job_ptr->step_hash, (char *) &step_ptr->step_id,
+		      sizeof(step_ptr->step_id)) == step_ptr)
+		xhash_delete(job_ptr->step_hash, (char *) &step_ptr->step_id,
+			     sizeof(step_ptr->step_id));
+}
+
 /*
  * _create_step_record - create an empty step_record for the specified job.
  * IN job_ptr - pointer to job table entry to have step record added
@@ -359,6 +397,7 @@ extern void step_list_purge(job_record_t *job_ptr)
 	}
 	list_iterator_destroy(step_iterator);
 	FREE_NULL_LIST(job_ptr->step_list);
+	xhash_free(job_ptr->step_hash);
 }
 
 /* _free_step_rec - delete a step record's data structures */
@@ -366,6 +405,8 @@ static void _free_step_rec(step_record_t *step_ptr)
 {
 	xassert(step_ptr);
 	xassert(step_ptr->magic == STEP_MAGIC);
+
+	_step_hash_remove(step_ptr);
 /*
  * FIXME: If job step record is preserved after completion,
  * the switch_g_job_step_complete() must be called upon completion
@@ -531,10 +572,21 @@ extern int _find_step_id(void *step_entry, void *key)
  */
 step_record_t *find_step_record(job_record_t *job_ptr, uint32_t step_id)
 {
+	step_record_t *step_ptr;
+
 	if (job_ptr == NULL)
 		return NULL;
 
-	return list_find_first(job_ptr->step_list, _find_step_id, &step_id);
+	if (job_ptr->step_hash && (step_ptr = xhash_get(job_ptr->step_hash,
+							(char *) &step_id,
+							sizeof(step_id))))
+		return step_ptr;
+
+	step_ptr = list_find_first(job_ptr->step_list, _find_step_id, &step_id);
+	if (step_ptr)
+		_step_hash_add(step_ptr);
+
+	return step_ptr;
 }
 
 
@@ -2560,6 +2612,7 @@ extern int step_create(job_step_create_request_msg_t *step_specs,
 	} else {
 		step_ptr->step_id = job_ptr->next_step_id++;
 	}
+	_step_hash_add(step_ptr);
 
 	/* Here is where the node list is set for the step */
 	if (step_specs->node_list &&
@@ -3996,6 +4049,7 @@ extern int load_step_state(job_record_t *job_ptr, Buf buffer,
 
 	/* set new values */
 	step_ptr->step_id      = step_id;
+	_step_hash_add(step_ptr);
 	step_ptr->cpu_count    = cpu_count;
 	step_ptr->cpus_per_task= cpus_per_task;
 	step_ptr->cyclic_alloc = cyclic_alloc;
@@ -4512,6 +4566,7 @@ extern step_record_t *build_extern_step(job_record_t *job_ptr)
 	step_ptr->state = JOB_RUNNING;
 	step_ptr->start_time = job_ptr->start_time;
 	step_ptr->step_id = SLURM_EXTERN_CONT;
+	_step_hash_add(step_ptr);
 	if (job_ptr->node_bitmap)
 		step_ptr->step_node_bitmap =
 			bit_copy(job_ptr->node_bitmap);
@@ -4535,6 +4590,7 @@ extern step_record_t *build_batch_step(job_record_t *job_ptr)
 	step_ptr->state = JOB_RUNNING;
 	step_ptr->start_time = job_ptr->start_time;
 	step_ptr->step_id = SLURM_BATCH_SCRIPT;
+	_step_hash_add(step_ptr);
 	step_ptr->batch_step = 1;
 
 	if (node_name2bitmap(job_ptr->batch_host, false,
@@ -78,6 +78,8 @@ bitstr_t *trigger_down_nodes_bitmap = NULL;
 bitstr_t *trigger_drained_nodes_bitmap = NULL;
 bitstr_t *trigger_fail_nodes_bitmap = NULL;
 bitstr_t *trigger_up_nodes_bitmap   = NULL;
+static bitstr_t *trigger_idle_nodes_bitmap = NULL;
+static time_t trigger_idle_nodes_time = 0;
 static bool trigger_bb_error = false;
 static bool trigger_node_reconfig = false;
 static bool trigger_pri_ctld_fail = false;
@@ -1162,6 +1164,36 @@ static void _trigger_other_event(trig_mgr_info_t *trig_in, time_t now)
 	}
 }
 
+/*
+ * Return a bitmap of nodes idle since at least min_idle. Idle triggers
+ * usually share a few offsets, so the last bitmap built is kept until the
+ * end of this trigger_process() pass rather than rescanning the node table
+ * for every trigger.
+ */
+static bitstr_t *_idle_nodes(time_t min_idle)
+{
+	node_record_t *node_ptr = node_record_table_ptr;
+	int i;
+
+	if (trigger_idle_nodes_bitmap && (trigger_idle_nodes_time == min_idle))
+		return trigger_idle_nodes_bitmap;
+
+	if (!trigger_idle_nodes_bitmap)
+		trigger_idle_nodes_bitmap = bit_alloc(node_record_count);
+	else
+		bit_nclear(trigger_idle_nodes_bitmap, 0,
+			   (bit_size(trigger_idle_nodes_bitmap) - 1));
+	for (i = 0; i < node_record_count; i++, node_ptr++) {
+		if (!IS_NODE_IDLE(node_ptr) ||
+		    (node_ptr->last_idle > min_idle))
+			continue;
+		bit_set(trigger_idle_nodes_bitmap, i);
+	}
+	trigger_idle_nodes_time = min_idle;
+
+	return trigger_idle_nodes_bitmap;
+}
+
 static void _trigger_node_event(trig_mgr_info_t *trig_in, time_t now)
 {
 	xassert(verify_lock(NODE_LOCK, READ_LOCK));
@@ -1254,17 +1286,8 @@ static void _trigger_node_event(trig_mgr_info_t *trig_in, time_t now)
 		/* We need to determine which (if any) of these
 		 * nodes have been idle for at least the offset time */
 		time_t min_idle = now - (trig_in->trig_time - 0x8000);
-		int i;
-		node_record_t *node_ptr = node_record_table_ptr;
-		bitstr_t *trigger_idle_node_bitmap;
+		bitstr_t *trigger_idle_node_bitmap = _idle_nodes(min_idle);
 
-		trigger_idle_node_bitmap = bit_alloc(node_record_count);
-		for (i = 0; i < node_record_count; i++, node_ptr++) {
-			if (!IS_NODE_IDLE(node_ptr) ||
-			    (node_ptr->last_idle > min_idle))
-				continue;
-			bit_set(trigger_idle_node_bitmap, i);
-		}
 		if (trig_in->nodes_bitmap == NULL) {    /* all nodes */
 			xfree(trig_in->res_id);
 			trig_in->res_id = bitmap2node_name(
@@ -1279,7 +1302,6 @@ static void _trigger_node_event(trig_mgr_info_t *trig_in, time_t now)
 					  trig_in->nodes_bitmap);
 			trig_in->state = 1;
 		}
-		FREE_NULL_BITMAP(trigger_idle_node_bitmap);
 		if (trig_in->state == 1) {
 			trig_in->trig_time = now;
 			if (slurmctld_conf.debug_flags & DEBUG_FLAG_TRIGGERS) {
@@ -1553,28 +1575,19 @@ static void _trigger_run_program(trig_mgr_info_t *trig_in)
 		xfree(args[i]);
 }
 
+/*
+ * The event bitmaps are released rather than cleared so a NULL bitmap means
+ * no such event happened since the last pass, letting the per-trigger tests
+ * skip their bitmap scans entirely on quiet passes.
+ */
 static void _clear_event_triggers(void)
 {
-	if (trigger_down_front_end_bitmap) {
-		bit_nclear(trigger_down_front_end_bitmap,
-			   0, (bit_size(trigger_down_front_end_bitmap) - 1));
-	}
-	if (trigger_up_front_end_bitmap) {
-		bit_nclear(trigger_up_front_end_bitmap,
-			   0, (bit_size(trigger_up_front_end_bitmap) - 1));
-	}
-	if (trigger_down_nodes_bitmap) {
-		bit_nclear(trigger_down_nodes_bitmap,
-			   0, (bit_size(trigger_down_nodes_bitmap) - 1));
-	}
-	if (trigger_drained_nodes_bitmap) {
-		bit_nclear(trigger_drained_nodes_bitmap,
-			   0, (bit_size(trigger_drained_nodes_bitmap) - 1));
-	}
-	if (trigger_up_nodes_bitmap) {
-		bit_nclear(trigger_up_nodes_bitmap,
-			   0, (bit_size(trigger_up_nodes_bitmap) - 1));
-	}
+	FREE_NULL_BITMAP(trigger_down_front_end_bitmap);
+	FREE_NULL_BITMAP(trigger_up_front_end_bitmap);
+	FREE_NULL_BITMAP(trigger_down_nodes_bitmap);
+	FREE_NULL_BITMAP(trigger_drained_nodes_bitmap);
+	FREE_NULL_BITMAP(trigger_up_nodes_bitmap);
+	FREE_NULL_BITMAP(trigger_idle_nodes_bitmap);
 	trigger_node_reconfig = false;
 	trigger_bb_error = false;
 	trigger_pri_ctld_fail = false;
@@ -1733,4 +1746,5 @@ extern void trigger_fini(void)
 	FREE_NULL_BITMAP(trigger_drained_nodes_bitmap);
 	FREE_NULL_BITMAP(trigger_fail_nodes_bitmap);
 	FREE_NULL_BITMAP(trigger_up_nodes_bitmap);
+	FREE_NULL_BITMAP(trigger_idle_nodes_bitmap);
 }
@@ -557,13 +557,30 @@ proc_req(void *conn, persist_msg_t *msg,
 		      slurmdbd_conn->conn->fd,
 		      slurmdbd_msg_type_2_str(msg->msg_type, 1));
 	else if (slurmdbd_conn->conn->rem_port
-		 && !slurmdbd_conf->commit_delay) {
+		 && !slurmdbd_conf->commit_delay
+		 && !slurmdbd_conn->in_mult_msg
+		 && (msg->msg_type != DBD_SEND_MULT_MSG)) {
 		/* If we are dealing with the slurmctld do the
 		   commit (SUCCESS or NOT) afterwards since we
 		   do transactions for performance reasons.
 		   (don't ever use autocommit with innodb)
+		   The messages inside a DBD_SEND_MULT_MSG are
+		   committed together by _send_mult_msg().
+		   If the commit fails, replace the reply with an
+		   error so the slurmctld keeps and resends the message.
 		*/
-		acct_storage_g_commit(slurmdbd_conn->db_conn, 1);
+		if ((acct_storage_g_commit(slurmdbd_conn->db_conn, 1) !=
+		     SLURM_SUCCESS) && (rc == SLURM_SUCCESS)) {
+			comment = "Commit failed";
+			error("CONN:%u %s for %s", slurmdbd_conn->conn->fd,
+			      comment,
+			      slurmdbd_msg_type_2_str(msg->msg_type, 1));
+			rc = SLURM_ERROR;
+			FREE_NULL_BUFFER(*out_buffer);
+			*out_buffer = slurm_persist_make_rc_msg(
+				slurmdbd_conn->conn, rc, comment,
+				msg->msg_type);
+		}
 	}
 
 	END_TIMER;
@@ -846,14 +863,21 @@ static int _add_tres(slurmdbd_conn_t *slurmdbd_conn,
 	rc = acct_storage_g_add_tres(slurmdbd_conn->db_conn, *uid,
 				     get_msg->my_list);
 
-	*out_buffer = slurm_persist_make_rc_msg(slurmdbd_conn->conn,
-						rc, comment, DBD_ADD_TRES);
-
 	/* This happens before the slurmctld registers and only when
 	   the slurmctld starts up.  So always commit, success or not.
 	   (don't ever use autocommit with innodb)
+	   Do it before the reply so a failed commit is reported.
 	*/
-	acct_storage_g_commit(slurmdbd_conn->db_conn, 1);
+	if ((acct_storage_g_commit(slurmdbd_conn->db_conn, 1) !=
+	     SLURM_SUCCESS) && (rc == SLURM_SUCCESS)) {
+		comment = "Commit failed";
+		error("CONN:%u DBD_ADD_TRES: %s",
+		      slurmdbd_conn->conn->fd, comment);
+		rc = SLURM_ERROR;
+	}
+
+	*out_buffer = slurm_persist_make_rc_msg(slurmdbd_conn->conn,
+						rc, comment, DBD_ADD_TRES);
 
 	return rc;
 }
@@ -1427,12 +1451,42 @@ static int _get_events(slurmdbd_conn_t *slurmdbd_conn,
 	return rc;
 }
 
+/*
+ * Pack a DBD_GOT_JOBS list message, same format as slurmdbd_pack_list_msg(),
+ * but free each job record as soon as it has been packed. A wide sacct query
+ * can return millions of records, so this keeps the job records and the
+ * packed response from both being held in full at the same time.
+ */
+static void _pack_job_list(List job_list, uint16_t rpc_version, Buf buffer)
+{
+	slurmdb_job_rec_t *job;
+	uint32_t header_position = get_buf_offset(buffer);
+	uint32_t count = list_count(job_list);
+	int rc = SLURM_SUCCESS;
+
+	pack32(count, buffer);
+	while ((job = list_pop(job_list))) {
+		slurmdb_pack_job_rec(job, rpc_version, buffer);
+		slurmdb_destroy_job_rec(job);
+		if (size_buf(buffer) > REASONABLE_BUF_SIZE) {
+			error("%s: size limit exceeded", __func__);
+			/* rewind buffer, pack NO_VAL as count instead */
+			set_buf_offset(buffer, header_position);
+			pack32(NO_VAL, buffer);
+			rc = ESLURM_RESULT_TOO_LARGE;
+			break;
+		}
+	}
+
+	pack32(rc, buffer);
+}
+
 static int _get_jobs_cond(slurmdbd_conn_t *slurmdbd_conn,
 			  persist_msg_t *msg, Buf *out_buffer, uint32_t *uid)
 {
 	dbd_cond_msg_t *cond_msg = msg->data;
-	dbd_list_msg_t list_msg = { NULL };
 	slurmdb_job_cond_t *job_cond = cond_msg->cond;
+	List job_list;
 	int rc = SLURM_SUCCESS;
 
 	debug2("DBD_GET_JOBS_COND: called");
@@ -1471,16 +1525,16 @@ static int _get_jobs_cond(slurmdbd_conn_t *slurmdbd_conn,
 		}
 	}
 
-	list_msg.my_list = jobacct_storage_g_get_jobs_cond(
+	job_list = jobacct_storage_g_get_jobs_cond(
 		slurmdbd_conn->db_conn, *uid, job_cond);
 
 	if (!errno) {
-		if (!list_msg.my_list)
-			list_msg.my_list = list_create(NULL);
+		if (!job_list)
+			job_list = list_create(NULL);
 		*out_buffer = init_buf(1024);
 		pack16((uint16_t) DBD_GOT_JOBS, *out_buffer);
-		slurmdbd_pack_list_msg(&list_msg, slurmdbd_conn->conn->version,
-				       DBD_GOT_JOBS, *out_buffer);
+		_pack_job_list(job_list, slurmdbd_conn->conn->version,
+			       *out_buffer);
 	} else {
 		*out_buffer = slurm_persist_make_rc_msg(slurmdbd_conn->conn,
 							errno,
@@ -1489,7 +1543,7 @@ static int _get_jobs_cond(slurmdbd_conn_t *slurmdbd_conn,
 		rc = SLURM_ERROR;
 	}
 
-	FREE_NULL_LIST(list_msg.my_list);
+	FREE_NULL_LIST(job_list);
 
 	return rc;
 }
@@ -3315,6 +3369,52 @@ static int   _send_mult_job_start(slurmdbd_conn_t *slurmdbd_conn,
 	return SLURM_SUCCESS;
 }
 
+/*
+ * Process up to max_cnt of the messages of a DBD_SEND_MULT_MSG, stopping at
+ * the first failure. Responses of the successful messages are appended to
+ * ret_list, the response of the failed one (if any) is returned in fail_buf.
+ * OUT proc_cnt - number of messages processed successfully
+ * RET return code of the failed message or SLURM_SUCCESS
+ */
+static int _proc_mult_msg(slurmdbd_conn_t *slurmdbd_conn, List req_list,
+			  int max_cnt, List ret_list, Buf *fail_buf,
+			  int *proc_cnt, uint32_t *uid)
+{
+	ListIterator itr;
+	Buf req_buf, ret_buf;
+	int rc = SLURM_SUCCESS;
+
+	*fail_buf = NULL;
+	*proc_cnt = 0;
+	itr = list_iterator_create(req_list);
+	while ((*proc_cnt < max_cnt) && (req_buf = list_next(itr))) {
+		persist_msg_t sub_msg;
+
+		ret_buf = NULL;
+
+		rc = slurm_persist_conn_process_msg(
+			slurmdbd_conn->conn, &sub_msg,
+			get_buf_data(req_buf),
+			size_buf(req_buf), &ret_buf, 0);
+
+		if (rc == SLURM_SUCCESS) {
+			rc = proc_req(slurmdbd_conn, &sub_msg, &ret_buf, uid);
+			slurmdbd_free_msg((slurmdbd_msg_t *)&sub_msg);
+		}
+
+		if (rc != SLURM_SUCCESS) {
+			*fail_buf = ret_buf;
+			break;
+		}
+		if (ret_buf)
+			list_append(ret_list, ret_buf);
+		(*proc_cnt)++;
+	}
+	list_iterator_destroy(itr);
+
+	return rc;
+}
+
 static int   _send_mult_msg(slurmdbd_conn_t *slurmdbd_conn,
 			    persist_msg_t *msg, Buf *out_buffer,
 			    uint32_t *uid)
@@ -3322,10 +3422,12 @@ static int   _send_mult_msg(slurmdbd_conn_t *slurmdbd_conn,
 	dbd_list_msg_t *get_msg = msg->data;
 	dbd_list_msg_t list_msg = { NULL };
 	char *comment = NULL;
-	ListIterator itr = NULL;
-	Buf req_buf = NULL, ret_buf = NULL;
-	int rc = SLURM_SUCCESS;
-	/* DEF_TIMERS; */
+	Buf fail_buf = NULL, retry_buf = NULL;
+	int rc, proc_cnt, retry_cnt;
+	/* Same condition as the commit done by proc_req() */
+	bool commit = (slurmdbd_conn->conn->rem_port &&
+		       !slurmdbd_conf->commit_delay);
+	DEF_TIMERS;
 
 	if (!_validate_slurm_user(*uid)) {
 		comment = "DBD_SEND_MULT_MSG message from invalid uid";
@@ -3337,32 +3439,55 @@ static int   _send_mult_msg(slurmdbd_conn_t *slurmdbd_conn,
 		return SLURM_ERROR;
 	}
 
+	START_TIMER;
+	/*
+	 * Don't commit after each message, commit the batch once below before
+	 * the response is built. The slurmctld drops every message we report
+	 * as successful, so each of them must be committed by then.
+	 */
 	list_msg.my_list = list_create(slurmdbd_free_buffer);
-	/* START_TIMER; */
-	itr = list_iterator_create(get_msg->my_list);
-	while ((req_buf = list_next(itr))) {
-		persist_msg_t sub_msg;
-
-		ret_buf = NULL;
-
-		rc = slurm_persist_conn_process_msg(
-			slurmdbd_conn->conn, &sub_msg,
-			get_buf_data(req_buf),
-			size_buf(req_buf), &ret_buf, 0);
-
-		if (rc == SLURM_SUCCESS) {
-			rc = proc_req(slurmdbd_conn, &sub_msg, &ret_buf, uid);
-			slurmdbd_free_msg((slurmdbd_msg_t *)&sub_msg);
-		}
-
-		if (ret_buf)
-			list_append(list_msg.my_list, ret_buf);
-		if (rc != SLURM_SUCCESS)
+	slurmdbd_conn->in_mult_msg = true;
+	rc = _proc_mult_msg(slurmdbd_conn, get_msg->my_list,
+			    list_count(get_msg->my_list), list_msg.my_list,
+			    &fail_buf, &proc_cnt, uid);
+	while (commit && (rc != SLURM_SUCCESS) && proc_cnt) {
+		/*
+		 * A failed statement may have rolled back the whole
+		 * transaction (e.g. an InnoDB deadlock), taking the messages
+		 * before it with it. Roll back and redo just those.
+		 */
+		acct_storage_g_commit(slurmdbd_conn->db_conn, 0);
+		list_flush(list_msg.my_list);
+		if (_proc_mult_msg(slurmdbd_conn, get_msg->my_list, proc_cnt,
+				   list_msg.my_list, &retry_buf, &retry_cnt,
+				   uid) == SLURM_SUCCESS)
 			break;
+		/* Failed earlier this time, report that one instead */
+		FREE_NULL_BUFFER(fail_buf);
+		fail_buf = retry_buf;
+		retry_buf = NULL;
+		proc_cnt = retry_cnt;
+	}
+	slurmdbd_conn->in_mult_msg = false;
+
+	if (commit &&
+	    (acct_storage_g_commit(slurmdbd_conn->db_conn, 1) !=
+	     SLURM_SUCCESS)) {
+		comment = "DBD_SEND_MULT_MSG commit failed";
+		error("%s, %d messages will be resent",
+		      comment, list_count(get_msg->my_list));
+		FREE_NULL_LIST(list_msg.my_list);
+		FREE_NULL_BUFFER(fail_buf);
+		*out_buffer = slurm_persist_make_rc_msg(slurmdbd_conn->conn,
+							SLURM_ERROR, comment,
+							DBD_SEND_MULT_MSG);
+		return SLURM_ERROR;
 	}
-	list_iterator_destroy(itr);
-	/* END_TIMER; */
-	/* info("%d multi took %s", list_count(get_msg->my_list), TIME_STR); */
+	if (fail_buf)
+		list_append(list_msg.my_list, fail_buf);
+	END_TIMER;
+	debug2("DBD_SEND_MULT_MSG: %d of %d messages processed in %s",
+	       proc_cnt, list_count(get_msg->my_list), TIME_STR);
 
 	*out_buffer = init_buf(1024);
 	pack16((uint16_t) DBD_GOT_MULT_MSG, *out_buffer);
@@ -46,6 +46,8 @@
 typedef struct {
 	slurm_persist_conn_t *conn;
 	void *db_conn; /* database connection */
+	bool in_mult_msg; /* processing the messages of a DBD_SEND_MULT_MSG,
+			   * commit once when they are all done */
 	char *tres_str;
 } slurmdbd_conn_t;
 
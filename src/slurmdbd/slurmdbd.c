@@ -810,8 +810,16 @@ static void *_commit_handler(void *db_conn)
 			while ((slurmdbd_conn = list_next(itr))) {
 				debug4("running commit for %s",
 				       slurmdbd_conn->conn->cluster_name);
-				acct_storage_g_commit(
-					slurmdbd_conn->db_conn, 1);
+				/*
+				 * The slurmctld was already answered, so
+				 * with CommitDelay a failure can only be
+				 * reported here.
+				 */
+				if (acct_storage_g_commit(
+					    slurmdbd_conn->db_conn, 1))
+					error("commit for %s failed, records received in the last %u seconds are lost",
+					      slurmdbd_conn->conn->cluster_name,
+					      slurmdbd_conf->commit_delay);
 			}
 			list_iterator_destroy(itr);
 			running_commit = 0;